@@ -0,0 +1,212 @@
+// See LICENSE for license details.
+
+// Compares the blocked CPU reference kernels in gemmini.h against their naive
+// versions on layer shapes taken from the mlps and imagenet workloads. The
+// outputs must match exactly. Build for a host with, e.g.,
+//   gcc -std=gnu99 -O3 -march=native -pthread -DGEMMINI_CPU_THREADS=8 -I.. cpu_reference_perf.c -lm
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "include/gemmini_testutils.h"
+
+#ifndef BAREMETAL
+#define MAX_A (3136*256)
+#define MAX_B (2560*2048)
+#define MAX_C (3136*256)
+#define MAX_BIAS 2560
+#else
+#define MAX_A (64*64)
+#define MAX_B (64*64)
+#define MAX_C (64*64)
+#define MAX_BIAS 64
+#endif
+
+static elem_t A[MAX_A];
+static elem_t B[MAX_B];
+static acc_t bias[MAX_BIAS];
+static elem_t gold[MAX_C];
+static elem_t C[MAX_C];
+
+struct matmul_shape {
+  const char * name;
+  size_t I, J, K;
+};
+
+struct conv_shape {
+  const char * name;
+  int batch_size, in_dim, in_channels, out_channels;
+  int stride, padding, kernel_dim;
+  int pool_size, pool_stride, pool_padding;
+};
+
+#ifndef BAREMETAL
+static const struct matmul_shape matmul_shapes[] = {
+  {"mlp1 layer 1", 64, 2560, 832},
+  {"mlp1 layer 2", 64, 2048, 2560},
+  {"resnet50 conv2_1 1x1", 3136, 256, 64},
+  {"resnet50 fc", 4, 1000, 2048},
+};
+
+static const struct conv_shape conv_shapes[] = {
+  {"resnet50 conv1 + pool", 1, 224, 3, 64, 2, 3, 7, 3, 2, 1},
+  {"resnet50 conv2_x 3x3", 1, 56, 64, 64, 1, 1, 3, 0, 0, 0},
+  {"resnet50 conv5_x 3x3", 4, 7, 512, 512, 1, 1, 3, 0, 0, 0},
+};
+
+static const struct conv_shape conv_dw_shapes[] = {
+  {"mobilenet conv_dw 112x112", 1, 112, 32, 32, 1, 1, 3, 0, 0, 0},
+  {"mobilenet conv_dw 14x14", 4, 14, 512, 512, 1, 1, 3, 0, 0, 0},
+};
+
+static const struct matmul_shape resadd_shapes[] = {
+  {"resnet50 conv2_x resadd", 3136, 256, 0},
+};
+#else
+static const struct matmul_shape matmul_shapes[] = {
+  {"small matmul", 33, 47, 61},
+};
+
+static const struct conv_shape conv_shapes[] = {
+  {"small conv + pool", 1, 9, 3, 20, 1, 1, 3, 3, 2, 1},
+};
+
+static const struct conv_shape conv_dw_shapes[] = {
+  {"small conv_dw", 2, 7, 20, 20, 2, 1, 3, 0, 0, 0},
+};
+
+static const struct matmul_shape resadd_shapes[] = {
+  {"small resadd", 35, 27, 0},
+};
+#endif
+
+#define LEN(arr) ((int) (sizeof (arr) / sizeof (arr[0])))
+
+static void init_random(elem_t * buf, size_t len) {
+  for (size_t i = 0; i < len; i++)
+    buf[i] = (rand() % 11) - 5;
+}
+
+static void init_random_bias(size_t len) {
+  for (size_t i = 0; i < len; i++)
+    bias[i] = (rand() % 201) - 100;
+}
+
+static bool check(const char * kernel, const char * name, size_t len,
+    uint64_t naive_cycles, uint64_t fast_cycles) {
+  bool equal = true;
+  for (size_t i = 0; i < len; i++)
+    equal &= gold[i] == C[i];
+
+  printf("%s %s: naive %llu, fast %llu (%llux)%s\n", kernel, name,
+      (unsigned long long)naive_cycles, (unsigned long long)fast_cycles,
+      (unsigned long long)(fast_cycles == 0 ? 0 : naive_cycles / fast_cycles),
+      equal ? "" : " MISMATCH");
+  return equal;
+}
+
+int main() {
+  bool success = true;
+
+  for (int s = 0; s < LEN(matmul_shapes); s++) {
+    const struct matmul_shape * sh = &matmul_shapes[s];
+    init_random(A, sh->I * sh->K);
+    init_random(B, sh->K * sh->J);
+    init_random_bias(sh->J);
+
+    uint64_t start = read_cycles();
+    matmul_cpu_naive(false, false, sh->I, sh->J, sh->K, A, B, bias, gold,
+        sh->K, sh->J, 0, sh->J,
+        MVIN_SCALE_IDENTITY, MVIN_SCALE_IDENTITY, MVIN_SCALE_IDENTITY,
+        RELU, 1.0 / 32, 0, true);
+    const uint64_t naive_cycles = read_cycles() - start;
+
+    start = read_cycles();
+    matmul_cpu(false, false, sh->I, sh->J, sh->K, A, B, bias, C,
+        sh->K, sh->J, 0, sh->J,
+        MVIN_SCALE_IDENTITY, MVIN_SCALE_IDENTITY, MVIN_SCALE_IDENTITY,
+        RELU, 1.0 / 32, 0, true);
+    const uint64_t fast_cycles = read_cycles() - start;
+
+    success &= check("matmul", sh->name, sh->I * sh->J, naive_cycles, fast_cycles);
+  }
+
+  for (int s = 0; s < LEN(conv_shapes); s++) {
+    const struct conv_shape * sh = &conv_shapes[s];
+    const int out_dim = (sh->in_dim + 2*sh->padding - sh->kernel_dim) / sh->stride + 1;
+    const int pool_out_dim = sh->pool_stride == 0 ? out_dim :
+      (out_dim + 2*sh->pool_padding - sh->pool_size) / sh->pool_stride + 1;
+    init_random(A, sh->batch_size * sh->in_dim * sh->in_dim * sh->in_channels);
+    init_random(B, sh->kernel_dim * sh->kernel_dim * sh->in_channels * sh->out_channels);
+    init_random_bias(sh->out_channels);
+
+    uint64_t start = read_cycles();
+    conv_cpu_naive(sh->batch_size, sh->in_dim, sh->in_channels, sh->out_channels, out_dim,
+        sh->stride, 1, 1, sh->padding, sh->kernel_dim,
+        false, false, false, false, false,
+        A, B, bias, gold,
+        RELU, 1.0 / 16, 0,
+        sh->pool_size, sh->pool_stride, sh->pool_padding);
+    const uint64_t naive_cycles = read_cycles() - start;
+
+    start = read_cycles();
+    conv_cpu(sh->batch_size, sh->in_dim, sh->in_channels, sh->out_channels, out_dim,
+        sh->stride, 1, 1, sh->padding, sh->kernel_dim,
+        false, false, false, false, false,
+        A, B, bias, C,
+        RELU, 1.0 / 16, 0,
+        sh->pool_size, sh->pool_stride, sh->pool_padding);
+    const uint64_t fast_cycles = read_cycles() - start;
+
+    success &= check("conv", sh->name,
+        sh->batch_size * pool_out_dim * pool_out_dim * sh->out_channels,
+        naive_cycles, fast_cycles);
+  }
+
+  for (int s = 0; s < LEN(conv_dw_shapes); s++) {
+    const struct conv_shape * sh = &conv_dw_shapes[s];
+    const int out_dim = (sh->in_dim + 2*sh->padding - sh->kernel_dim) / sh->stride + 1;
+    init_random(A, sh->batch_size * sh->in_dim * sh->in_dim * sh->in_channels);
+    init_random(B, sh->in_channels * sh->kernel_dim * sh->kernel_dim);
+    init_random_bias(sh->in_channels);
+
+    uint64_t start = read_cycles();
+    conv_dw_cpu_naive(sh->batch_size, sh->in_dim, sh->in_channels, out_dim,
+        sh->stride, sh->padding, sh->kernel_dim,
+        A, B, bias, gold,
+        RELU6, 1.0 / 4, 2,
+        sh->pool_size, sh->pool_stride, sh->pool_padding);
+    const uint64_t naive_cycles = read_cycles() - start;
+
+    start = read_cycles();
+    conv_dw_cpu(sh->batch_size, sh->in_dim, sh->in_channels, out_dim,
+        sh->stride, sh->padding, sh->kernel_dim,
+        A, B, bias, C,
+        RELU6, 1.0 / 4, 2,
+        sh->pool_size, sh->pool_stride, sh->pool_padding);
+    const uint64_t fast_cycles = read_cycles() - start;
+
+    success &= check("conv_dw", sh->name,
+        sh->batch_size * out_dim * out_dim * sh->in_channels,
+        naive_cycles, fast_cycles);
+  }
+
+  for (int s = 0; s < LEN(resadd_shapes); s++) {
+    const struct matmul_shape * sh = &resadd_shapes[s];
+    init_random(A, sh->I * sh->J);
+    init_random(B, sh->I * sh->J);
+
+    uint64_t start = read_cycles();
+    resadd_cpu_naive(sh->I, sh->J, 2, MVIN_SCALE_IDENTITY, ACC_SCALE_IDENTITY, A, B, gold, true);
+    const uint64_t naive_cycles = read_cycles() - start;
+
+    start = read_cycles();
+    resadd_cpu(sh->I, sh->J, 2, MVIN_SCALE_IDENTITY, ACC_SCALE_IDENTITY, A, B, C, true);
+    const uint64_t fast_cycles = read_cycles() - start;
+
+    success &= check("resadd", sh->name, sh->I * sh->J, naive_cycles, fast_cycles);
+  }
+
+  exit(success ? 0 : 1);
+}
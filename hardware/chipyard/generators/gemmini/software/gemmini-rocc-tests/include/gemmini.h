@@ -759,6 +759,67 @@ static elem_t scale_and_sat(acc_t x, int act, acc_scale_t scale, size_t relu6_sh
   return x;
 }
 
+// The CPU reference kernels split their outermost loop across
+// GEMMINI_CPU_THREADS pthreads in Linux builds, e.g. host-side checking runs
+// built with -DGEMMINI_CPU_THREADS=8 -pthread. Baremetal and pk builds always
+// run them on the calling core.
+#ifndef GEMMINI_CPU_THREADS
+#define GEMMINI_CPU_THREADS 1
+#endif
+
+#if GEMMINI_CPU_THREADS > 1 && !defined(BAREMETAL)
+#include <pthread.h>
+#endif
+
+typedef void (*cpu_kernel_t)(const void * args, size_t start, size_t end);
+
+struct cpu_kernel_task {
+  cpu_kernel_t kernel;
+  const void * args;
+  size_t start, end;
+};
+
+static void * cpu_kernel_task_run(void * arg) {
+  const struct cpu_kernel_task * task = (const struct cpu_kernel_task *) arg;
+  task->kernel(task->args, task->start, task->end);
+  return NULL;
+}
+
+// Runs kernel(args, start, end) over disjoint slices covering [0, n)
+static void cpu_parallel_for(size_t n, cpu_kernel_t kernel, const void * args) {
+#if GEMMINI_CPU_THREADS > 1 && !defined(BAREMETAL)
+  const size_t nthreads = n < GEMMINI_CPU_THREADS ? n : GEMMINI_CPU_THREADS;
+  struct cpu_kernel_task tasks[GEMMINI_CPU_THREADS];
+  pthread_t threads[GEMMINI_CPU_THREADS];
+  bool started[GEMMINI_CPU_THREADS];
+
+  if (nthreads == 0)
+    return;
+
+  for (size_t t = 0; t < nthreads; t++) {
+    tasks[t].kernel = kernel;
+    tasks[t].args = args;
+    tasks[t].start = n * t / nthreads;
+    tasks[t].end = n * (t + 1) / nthreads;
+  }
+
+  for (size_t t = 1; t < nthreads; t++)
+    started[t] = pthread_create(&threads[t], NULL, cpu_kernel_task_run, &tasks[t]) == 0;
+
+  // The first slice runs here, as do slices whose thread failed to start
+  cpu_kernel_task_run(&tasks[0]);
+
+  for (size_t t = 1; t < nthreads; t++) {
+    if (started[t])
+      pthread_join(threads[t], NULL);
+    else
+      cpu_kernel_task_run(&tasks[t]);
+  }
+#else
+  kernel(args, 0, n);
+#endif
+}
+
 #ifdef HAS_MVIN_SCALE
 #define GEMMINI_SCALE(x, scale) MVIN_SCALE((x), (scale))
 #else
@@ -771,7 +832,8 @@ static elem_t scale_and_sat(acc_t x, int act, acc_scale_t scale, size_t relu6_sh
 #define GEMMINI_ACC_SCALE(x, scale) (x)
 #endif
 
-static void matmul_cpu(bool transA, bool transB, size_t DIM_I, size_t DIM_J, size_t DIM_K,
+// Straightforward golden model for matmul_cpu, kept for comparison
+static void matmul_cpu_naive(bool transA, bool transB, size_t DIM_I, size_t DIM_J, size_t DIM_K,
         const elem_t* A, const elem_t* B, const acc_t * D,
         elem_t* C,
         size_t stride_A, size_t stride_B, size_t stride_D, size_t stride_C,
@@ -898,6 +960,125 @@ static void matmul_cpu(bool transA, bool transB, size_t DIM_I, size_t DIM_J, siz
   }
 }
 
+#define MATMUL_CPU_BLOCK_I 16
+#define MATMUL_CPU_BLOCK_J 64
+#define MATMUL_CPU_BLOCK_K 128
+
+struct matmul_cpu_args {
+  bool transA, transB;
+  size_t DIM_I, DIM_J, DIM_K;
+  const elem_t * A;
+  const elem_t * B;
+  const acc_t * D;
+  elem_t * C;
+  size_t stride_A, stride_B, stride_D, stride_C;
+  scale_t A_scale_factor, B_scale_factor;
+  scale_acc_t D_scale_factor;
+  int act;
+  acc_scale_t scale;
+  size_t relu6_shift;
+  bool repeating_bias;
+};
+
+// Computes rows [i_start, i_end) of C one cache-sized block at a time. A and
+// B blocks are copied, already scaled, into contiguous buffers so that the
+// innermost loop is a unit-stride multiply-accumulate for any transposition.
+static void matmul_cpu_rows(const void * args_, size_t i_start, size_t i_end) {
+  const struct matmul_cpu_args * args = (const struct matmul_cpu_args *) args_;
+  const bool no_bias = args->D == NULL;
+  // Scaling an integer by exactly one leaves it unchanged
+  const bool A_identity = args->A_scale_factor == MVIN_SCALE_IDENTITY;
+  const bool B_identity = args->B_scale_factor == MVIN_SCALE_IDENTITY;
+
+  elem_t A_block[MATMUL_CPU_BLOCK_I][MATMUL_CPU_BLOCK_K];
+  elem_t B_block[MATMUL_CPU_BLOCK_K][MATMUL_CPU_BLOCK_J];
+  acc_t C_block[MATMUL_CPU_BLOCK_I][MATMUL_CPU_BLOCK_J];
+
+  for (size_t i0 = i_start; i0 < i_end; i0 += MATMUL_CPU_BLOCK_I) {
+    const size_t I = i_end - i0 < MATMUL_CPU_BLOCK_I ? i_end - i0 : MATMUL_CPU_BLOCK_I;
+
+    for (size_t j0 = 0; j0 < args->DIM_J; j0 += MATMUL_CPU_BLOCK_J) {
+      const size_t J = args->DIM_J - j0 < MATMUL_CPU_BLOCK_J ? args->DIM_J - j0 : MATMUL_CPU_BLOCK_J;
+
+      for (size_t i = 0; i < I; i++) {
+        const size_t bias_row = args->repeating_bias ? 0 : i0 + i;
+        for (size_t j = 0; j < J; j++)
+          C_block[i][j] = no_bias ? 0 :
+            GEMMINI_ACC_SCALE(*(args->D + bias_row * args->stride_D + j0 + j), args->D_scale_factor);
+      }
+
+      for (size_t k0 = 0; k0 < args->DIM_K; k0 += MATMUL_CPU_BLOCK_K) {
+        const size_t K = args->DIM_K - k0 < MATMUL_CPU_BLOCK_K ? args->DIM_K - k0 : MATMUL_CPU_BLOCK_K;
+
+        for (size_t i = 0; i < I; i++)
+          for (size_t k = 0; k < K; k++) {
+            const elem_t * a = args->transA ?
+              args->A + (k0 + k) * args->stride_A + i0 + i :
+              args->A + (i0 + i) * args->stride_A + k0 + k;
+            A_block[i][k] = A_identity ? *a : GEMMINI_SCALE(*a, args->A_scale_factor);
+          }
+
+        for (size_t k = 0; k < K; k++)
+          for (size_t j = 0; j < J; j++) {
+            const elem_t * b = args->transB ?
+              args->B + (j0 + j) * args->stride_B + k0 + k :
+              args->B + (k0 + k) * args->stride_B + j0 + j;
+            B_block[k][j] = B_identity ? *b : GEMMINI_SCALE(*b, args->B_scale_factor);
+          }
+
+        for (size_t i = 0; i < I; i++)
+          for (size_t k = 0; k < K; k++) {
+            const acc_t a = A_block[i][k];
+            for (size_t j = 0; j < J; j++)
+              C_block[i][j] += a * B_block[k][j];
+          }
+      }
+
+      for (size_t i = 0; i < I; i++)
+        for (size_t j = 0; j < J; j++)
+          *(args->C + (i0 + i) * args->stride_C + j0 + j) =
+            scale_and_sat(C_block[i][j], args->act, args->scale, args->relu6_shift);
+    }
+  }
+}
+
+// Threads are handed whole row blocks
+static void matmul_cpu_row_blocks(const void * args_, size_t start, size_t end) {
+  const struct matmul_cpu_args * args = (const struct matmul_cpu_args *) args_;
+  const size_t i_end = end * MATMUL_CPU_BLOCK_I;
+  matmul_cpu_rows(args_, start * MATMUL_CPU_BLOCK_I, i_end < args->DIM_I ? i_end : args->DIM_I);
+}
+
+// Integer sums are exact regardless of order, so this matches
+// matmul_cpu_naive bit-for-bit. Floating-point configurations keep the naive
+// summation order.
+static void matmul_cpu(bool transA, bool transB, size_t DIM_I, size_t DIM_J, size_t DIM_K,
+        const elem_t* A, const elem_t* B, const acc_t * D,
+        elem_t* C,
+        size_t stride_A, size_t stride_B, size_t stride_D, size_t stride_C,
+        scale_t A_scale_factor, scale_t B_scale_factor, scale_acc_t D_scale_factor,
+        int act, acc_scale_t scale, size_t relu6_shift, bool repeating_bias) {
+#ifdef ELEM_T_IS_FLOAT
+  matmul_cpu_naive(transA, transB, DIM_I, DIM_J, DIM_K,
+      A, B, D, C,
+      stride_A, stride_B, stride_D, stride_C,
+      A_scale_factor, B_scale_factor, D_scale_factor,
+      act, scale, relu6_shift, repeating_bias);
+#else
+  const struct matmul_cpu_args args = {
+    transA, transB,
+    DIM_I, DIM_J, DIM_K,
+    A, B, D, C,
+    stride_A, stride_B, stride_D, stride_C,
+    A_scale_factor, B_scale_factor, D_scale_factor,
+    act, scale, relu6_shift, repeating_bias,
+  };
+
+  const size_t row_blocks = DIM_I / MATMUL_CPU_BLOCK_I + (DIM_I % MATMUL_CPU_BLOCK_I != 0);
+  cpu_parallel_for(row_blocks, matmul_cpu_row_blocks, &args);
+#endif
+}
+
 #undef GEMMINI_SCALE
 
 // General matmul which can be run with different dataflows, or on the CPU
@@ -1945,7 +2126,8 @@ static void conv_dw_cpu_without_pool(
 }
 
 
-static void conv_cpu(
+// Straightforward golden model for conv_cpu, kept for comparison
+static void conv_cpu_naive(
         int batch_size, int in_dim, int in_channels,
         int out_channels, int out_dim,
         int stride, int input_dilation, int kernel_dilation, int padding, int kernel_dim,
@@ -2063,7 +2245,8 @@ static void conv_cpu(
 }
 
 
-static void conv_dw_cpu(
+// Straightforward golden model for conv_dw_cpu, kept for comparison
+static void conv_dw_cpu_naive(
         int batch_size, int in_dim, int channels, int out_dim,
         int stride, int padding, int kernel_dim,
 
@@ -2149,6 +2332,287 @@ static void conv_dw_cpu(
 }
 
 
+#define CONV_CPU_BLOCK_CHS 64
+
+// Computes output channels [ch0, ch0 + chs) of the unpooled output pixel
+// (b, orow, ocol), scaled and saturated
+typedef void (*conv_cpu_pixel_t)(const void * args, int b, int orow, int ocol,
+        int ch0, int chs, elem_t * opixels);
+
+struct conv_cpu_rows_args {
+  conv_cpu_pixel_t pixel;
+  const void * pixel_args;
+  int batch_size, out_dim, channels;
+  bool trans_output_1203;
+  elem_t * output;
+  int pool_size, pool_stride, pool_padding, pool_out_dim;
+};
+
+// Produces output rows [start, end), counted over all batches, a block of
+// channels at a time. Pooling follows the running-max rules of the naive
+// kernels, including treating padding as zeros.
+static void conv_cpu_rows(const void * args_, size_t start, size_t end) {
+  const struct conv_cpu_rows_args * args = (const struct conv_cpu_rows_args *) args_;
+  const bool no_pool = args->pool_stride == 0;
+  const int rows = no_pool ? args->out_dim : args->pool_out_dim;
+
+  elem_t opixels[CONV_CPU_BLOCK_CHS];
+  elem_t running_max[CONV_CPU_BLOCK_CHS];
+
+  for (size_t r = start; r < end; r++) {
+    const int b = r / rows;
+    const int row = r % rows;
+
+    for (int col = 0; col < rows; col++) {
+      elem_t * out = args->output + ((b * rows + row) * rows + col) * args->channels;
+      if (args->trans_output_1203) {
+        // NHWC to HWNC
+        out = args->output + ((row * rows + col) * args->batch_size + b) * args->channels;
+      }
+
+      for (int ch0 = 0; ch0 < args->channels; ch0 += CONV_CPU_BLOCK_CHS) {
+        const int chs = args->channels - ch0 < CONV_CPU_BLOCK_CHS ?
+          args->channels - ch0 : CONV_CPU_BLOCK_CHS;
+
+        if (no_pool) {
+          args->pixel(args->pixel_args, b, row, col, ch0, chs, out + ch0);
+          continue;
+        }
+
+        bool running_max_initialized = false;
+
+        for (int pwrow = 0; pwrow < args->pool_size; pwrow++) {
+          const int orow = row * args->pool_stride + pwrow - args->pool_padding;
+
+          for (int pwcol = 0; pwcol < args->pool_size; pwcol++) {
+            const int ocol = col * args->pool_stride + pwcol - args->pool_padding;
+
+            if (orow < 0 || orow >= args->out_dim || ocol < 0 || ocol >= args->out_dim) {
+              for (int ch = 0; ch < chs; ch++)
+                if (!running_max_initialized || running_max[ch] < 0)
+                  running_max[ch] = 0;
+            } else {
+              args->pixel(args->pixel_args, b, orow, ocol, ch0, chs, opixels);
+              for (int ch = 0; ch < chs; ch++)
+                if (!running_max_initialized || opixels[ch] > running_max[ch])
+                  running_max[ch] = opixels[ch];
+            }
+
+            running_max_initialized = true;
+          }
+        }
+
+        for (int ch = 0; ch < chs; ch++)
+          out[ch0 + ch] = running_max[ch];
+      }
+    }
+  }
+}
+
+static void conv_cpu_parallel(conv_cpu_pixel_t pixel, const void * pixel_args,
+        int batch_size, int out_dim, int channels, bool trans_output_1203, elem_t * output,
+        int pool_size, int pool_stride, int pool_padding) {
+  const bool no_pool = pool_stride == 0;
+  const struct conv_cpu_rows_args args = {
+    pixel, pixel_args,
+    batch_size, out_dim, channels,
+    trans_output_1203, output,
+    pool_size, pool_stride, pool_padding,
+    no_pool ? 0 : (out_dim + 2*pool_padding - pool_size) / pool_stride + 1,
+  };
+
+  cpu_parallel_for((size_t)batch_size * (no_pool ? out_dim : args.pool_out_dim), conv_cpu_rows, &args);
+}
+
+struct conv_cpu_args {
+  int batch_size, in_dim, in_channels, out_channels;
+  int stride, input_dilation, kernel_dilation, padding, kernel_dim;
+  bool wrot180, trans_input_3120, trans_weight_1203, trans_weight_0132;
+  const elem_t * input;
+  const elem_t * weights;
+  const acc_t * bias;
+  int act;
+  acc_scale_t scale;
+  size_t relu6_shift;
+};
+
+// Accumulates each input pixel into a block of output channels at once; the
+// weights for consecutive output channels are contiguous unless they were
+// transposed with trans_weight_0132
+static void conv_cpu_pixel(const void * args_, int b, int orow, int ocol,
+        int och0, int ochs, elem_t * opixels) {
+  const struct conv_cpu_args * args = (const struct conv_cpu_args *) args_;
+  const int in_dim = args->in_dim, in_channels = args->in_channels;
+  const int out_channels = args->out_channels, kernel_dim = args->kernel_dim;
+
+  acc_t opixel[CONV_CPU_BLOCK_CHS];
+  for (int och = 0; och < ochs; och++)
+    opixel[och] = args->bias == NULL ? 0 : args->bias[och0 + och];
+
+  for (int krow = 0; krow < kernel_dim; krow++) {
+    if ((orow * args->stride + krow * args->kernel_dilation - args->padding) % args->input_dilation != 0)
+      continue;
+
+    const int irow = (orow * args->stride + krow * args->kernel_dilation - args->padding) / args->input_dilation;
+    if (irow < 0 || irow >= in_dim)
+      continue;
+
+    for (int kcol = 0; kcol < kernel_dim; kcol++) {
+      if ((ocol * args->stride + kcol * args->kernel_dilation - args->padding) % args->input_dilation != 0)
+        continue;
+
+      const int icol = (ocol * args->stride + kcol * args->kernel_dilation - args->padding) / args->input_dilation;
+      if (icol < 0 || icol >= in_dim)
+        continue;
+
+      const int krow_ = args->wrot180 ? kernel_dim - krow - 1 : krow;
+      const int kcol_ = args->wrot180 ? kernel_dim - kcol - 1 : kcol;
+
+      for (int kch = 0; kch < in_channels; kch++) {
+        const elem_t ipixel = args->trans_input_3120 ?
+          args->input[(kch * in_dim * in_dim + irow * in_dim + icol) * args->batch_size + b] :
+          args->input[(b * in_dim * in_dim + irow * in_dim + icol) * in_channels + kch];
+
+        if (ipixel == 0)
+          continue;
+
+        if (args->trans_weight_1203) {
+          const elem_t * weight = args->weights + (kch * kernel_dim * kernel_dim + krow_ * kernel_dim + kcol_) * out_channels + och0;
+          for (int och = 0; och < ochs; och++)
+            opixel[och] += weight[och] * ipixel;
+        } else if (args->trans_weight_0132) {
+          const elem_t * weight = args->weights + (krow_ * kernel_dim * out_channels + kcol_ * out_channels + och0) * in_channels + kch;
+          for (int och = 0; och < ochs; och++)
+            opixel[och] += weight[och * in_channels] * ipixel;
+        } else {
+          const elem_t * weight = args->weights + (krow_ * kernel_dim * in_channels + kcol_ * in_channels + kch) * out_channels + och0;
+          for (int och = 0; och < ochs; och++)
+            opixel[och] += weight[och] * ipixel;
+        }
+      }
+    }
+  }
+
+  for (int och = 0; och < ochs; och++)
+    opixels[och] = scale_and_sat(opixel[och], args->act, args->scale, args->relu6_shift);
+}
+
+// Matches conv_cpu_naive bit-for-bit; see matmul_cpu
+static void conv_cpu(
+        int batch_size, int in_dim, int in_channels,
+        int out_channels, int out_dim,
+        int stride, int input_dilation, int kernel_dilation, int padding, int kernel_dim,
+        bool wrot180, bool trans_output_1203, bool trans_input_3120,
+        bool trans_weight_1203, bool trans_weight_0132,
+
+        const elem_t * input,
+        const elem_t * weights,
+        const acc_t * bias,
+        elem_t * output,
+
+        int act, acc_scale_t scale, size_t relu6_shift,
+        int pool_size, int pool_stride, int pool_padding) {
+#ifdef ELEM_T_IS_FLOAT
+  conv_cpu_naive(
+      batch_size, in_dim, in_channels,
+      out_channels, out_dim,
+      stride, input_dilation, kernel_dilation, padding, kernel_dim,
+      wrot180, trans_output_1203, trans_input_3120,
+      trans_weight_1203, trans_weight_0132,
+      input, weights, bias, output,
+      act, scale, relu6_shift,
+      pool_size, pool_stride, pool_padding);
+#else
+  const struct conv_cpu_args args = {
+    batch_size, in_dim, in_channels, out_channels,
+    stride, input_dilation, kernel_dilation, padding, kernel_dim,
+    wrot180, trans_input_3120, trans_weight_1203, trans_weight_0132,
+    input, weights, bias,
+    act, scale, relu6_shift,
+  };
+
+  conv_cpu_parallel(conv_cpu_pixel, &args,
+      batch_size, out_dim, out_channels, trans_output_1203, output,
+      pool_size, pool_stride, pool_padding);
+#endif
+}
+
+struct conv_dw_cpu_args {
+  int in_dim, channels;
+  int stride, padding, kernel_dim;
+  const elem_t * input;
+  const elem_t * weights;
+  const acc_t * bias;
+  int act;
+  acc_scale_t scale;
+  size_t relu6_shift;
+};
+
+static void conv_dw_cpu_pixel(const void * args_, int b, int orow, int ocol,
+        int ch0, int chs, elem_t * opixels) {
+  const struct conv_dw_cpu_args * args = (const struct conv_dw_cpu_args *) args_;
+  const int in_dim = args->in_dim, channels = args->channels, kernel_dim = args->kernel_dim;
+
+  acc_t opixel[CONV_CPU_BLOCK_CHS];
+  for (int ch = 0; ch < chs; ch++)
+    opixel[ch] = args->bias == NULL ? 0 : args->bias[ch0 + ch];
+
+  for (int krow = 0; krow < kernel_dim; krow++) {
+    const int irow = orow * args->stride + krow - args->padding;
+    if (irow < 0 || irow >= in_dim)
+      continue;
+
+    for (int kcol = 0; kcol < kernel_dim; kcol++) {
+      const int icol = ocol * args->stride + kcol - args->padding;
+      if (icol < 0 || icol >= in_dim)
+        continue;
+
+      const elem_t * in = args->input + (b * in_dim * in_dim + irow * in_dim + icol) * channels + ch0;
+      const elem_t * weight = args->weights + (ch0 * kernel_dim + krow) * kernel_dim + kcol;
+
+      for (int ch = 0; ch < chs; ch++)
+        opixel[ch] += weight[ch * kernel_dim * kernel_dim] * in[ch];
+    }
+  }
+
+  for (int ch = 0; ch < chs; ch++)
+    opixels[ch] = scale_and_sat(opixel[ch], args->act, args->scale, args->relu6_shift);
+}
+
+// Matches conv_dw_cpu_naive bit-for-bit; see matmul_cpu
+static void conv_dw_cpu(
+        int batch_size, int in_dim, int channels, int out_dim,
+        int stride, int padding, int kernel_dim,
+
+        const elem_t * input,
+        const elem_t * weights,
+        const acc_t * bias,
+        elem_t * output,
+
+        int act, acc_scale_t scale, size_t relu6_shift,
+        int pool_size, int pool_stride, int pool_padding) {
+#ifdef ELEM_T_IS_FLOAT
+  conv_dw_cpu_naive(
+      batch_size, in_dim, channels, out_dim,
+      stride, padding, kernel_dim,
+      input, weights, bias, output,
+      act, scale, relu6_shift,
+      pool_size, pool_stride, pool_padding);
+#else
+  const struct conv_dw_cpu_args args = {
+    in_dim, channels,
+    stride, padding, kernel_dim,
+    input, weights, bias,
+    act, scale, relu6_shift,
+  };
+
+  conv_cpu_parallel(conv_dw_cpu_pixel, &args,
+      batch_size, out_dim, channels, false, output,
+      pool_size, pool_stride, pool_padding);
+#endif
+}
+
+
 static void tiled_conv(
         int batch_size, int in_dim, int in_channels,
         int out_channels, int out_dim,
@@ -2981,7 +3445,8 @@ static void tiled_conv_dw_auto(
 }
 
 
-static void resadd_cpu(const size_t I, const size_t J,
+// Straightforward golden model for resadd_cpu, kept for comparison
+static void resadd_cpu_naive(const size_t I, const size_t J,
         const scale_t A_scale,
         const scale_t B_scale,
         const acc_scale_t C_scale,
@@ -3008,6 +3473,67 @@ static void resadd_cpu(const size_t I, const size_t J,
     }
 }
 
+struct resadd_cpu_args {
+    size_t J;
+    scale_t A_scale, B_scale;
+    acc_scale_t C_scale;
+    const elem_t * A;
+    const elem_t * B;
+    elem_t * C;
+    bool relu;
+};
+
+static void resadd_cpu_rows(const void * args_, size_t start, size_t end) {
+    const struct resadd_cpu_args * args = (const struct resadd_cpu_args *) args_;
+    const size_t J = args->J;
+    const int minimum = args->relu ? 0 : elem_t_min;
+
+    // Identity scales skip the rounding in MVIN_SCALE and ACC_SCALE, as in
+    // matmul_cpu_rows
+    const bool A_identity = args->A_scale == MVIN_SCALE_IDENTITY;
+    const bool B_identity = args->B_scale == MVIN_SCALE_IDENTITY;
+    const bool C_identity = args->C_scale == ACC_SCALE_IDENTITY;
+
+    for (size_t i = start; i < end; i++) {
+        const elem_t * a = args->A + i * J;
+        const elem_t * b = args->B + i * J;
+        elem_t * c = args->C + i * J;
+
+        for (size_t j = 0; j < J; j++) {
+            const acc_t a_scaled = A_identity ? a[j] : MVIN_SCALE(a[j], args->A_scale);
+            const acc_t b_scaled = B_identity ? b[j] : MVIN_SCALE(b[j], args->B_scale);
+
+            acc_t result = a_scaled + b_scaled;
+            if (!C_identity)
+                result = ACC_SCALE(result, args->C_scale);
+            result = result > elem_t_max ? elem_t_max :
+                (result < minimum ? minimum : result);
+
+            c[j] = result;
+        }
+    }
+}
+
+// Matches resadd_cpu_naive bit-for-bit; see matmul_cpu
+static void resadd_cpu(const size_t I, const size_t J,
+        const scale_t A_scale,
+        const scale_t B_scale,
+        const acc_scale_t C_scale,
+        const elem_t * A,
+        const elem_t * B,
+        elem_t * C,
+        bool relu) {
+#ifdef ELEM_T_IS_FLOAT
+    resadd_cpu_naive(I, J, A_scale, B_scale, C_scale, A, B, C, relu);
+#else
+    const struct resadd_cpu_args args = {
+        J, A_scale, B_scale, C_scale, A, B, C, relu,
+    };
+
+    cpu_parallel_for(I, resadd_cpu_rows, &args);
+#endif
+}
+
 
 static void sp_tiled_resadd(const size_t I, const size_t J,
         const scale_t A_scale,
@@ -11,6 +11,9 @@
 #include <math.h>
 #include <limits.h>
 #include <stdbool.h>
+#ifndef __riscv
+#include <time.h>
+#endif
 
 #include "include/gemmini_params.h"
 #include "include/gemmini.h"
@@ -281,9 +284,17 @@ static int is_equal_transposed(elem_t x[DIM][DIM], elem_t y[DIM][DIM]) {
       result;})
 
 static uint64_t read_cycles() {
+#ifdef __riscv
     uint64_t cycles;
     asm volatile ("rdcycle %0" : "=r" (cycles));
     return cycles;
+#else
+    // Host builds, e.g. for checking against the CPU reference kernels, count
+    // nanoseconds instead
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
 
     // const uint32_t * mtime = (uint32_t *)(33554432 + 0xbff8);
     // const uint32_t * mtime = (uint32_t *)(33554432 + 0xbffc);
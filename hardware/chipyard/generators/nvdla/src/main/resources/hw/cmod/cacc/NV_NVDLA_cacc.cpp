@@ -50,6 +50,10 @@ NV_NVDLA_cacc::NV_NVDLA_cacc( sc_module_name module_name ):
     // No matter which precision (int8, Int16 and FP16) is used, both assembly and delivery ram use the highest bit consumption precision which is Int16
     assembly_sram_group_    = new sc_int<ACCU_ASSEMBLY_BIT_WIDTH_INT16> [SRAM_GROUP_SIZE];
     delivery_sram_group_    = new sc_int<ACCU_DELIVERY_BIT_WIDTH_INT16> [SRAM_GROUP_SIZE];
+    functional_fast_mode_   = NvdlaFunctionalFastModeEnabled();
+    assembly_sram_group_native_ = new int64_t [SRAM_GROUP_SIZE];
+    delivery_sram_group_native_ = new int64_t [SRAM_GROUP_SIZE];
+    layer_executor_.set_thread_num(NvdlaFunctionalFastModeThreadNum());
     mac_a2acc_fifo_ = new sc_fifo <nvdla_mac2accu_data_if_t *> (1);
     mac_b2acc_fifo_ = new sc_fifo <nvdla_mac2accu_data_if_t *> (1);
     to_sdp_fifo_    = new sc_core::sc_fifo <sc_int<32> *> (SRAM_GROUP_SIZE*4);
@@ -82,6 +86,8 @@ NV_NVDLA_cacc::NV_NVDLA_cacc( sc_module_name module_name ):
 NV_NVDLA_cacc::~NV_NVDLA_cacc() {
     if( assembly_sram_group_ )                  delete [] assembly_sram_group_;
     if( delivery_sram_group_ )                  delete [] delivery_sram_group_;
+    if( assembly_sram_group_native_ )           delete [] assembly_sram_group_native_;
+    if( delivery_sram_group_native_ )           delete [] delivery_sram_group_native_;
     if( mac_a2acc_fifo_ )                       delete mac_a2acc_fifo_;
     if( mac_b2acc_fifo_ )                       delete mac_b2acc_fifo_;
 }
@@ -96,6 +102,9 @@ void NV_NVDLA_cacc::Reset()
 
     cacc2glb_done_intr[0].initialize(false);
     cacc2glb_done_intr[1].initialize(false);
+    if (functional_fast_mode_) {
+        cslInfo(("NV_NVDLA_cacc: functional fast mode enabled for INT8/INT16 layers, up to %d host threads\n", NvdlaFunctionalFastModeThreadNum()));
+    }
 }
 
 void NV_NVDLA_cacc::CaccConsumerThread () {
@@ -108,7 +117,9 @@ void NV_NVDLA_cacc::CaccConsumerThread () {
         cacc_reg_model::CaccUpdateWorkingStatus(0,1);
         cacc_reg_model::CaccUpdateVariables(cacc_register_group_0);
         CaccHardwareLayerExecutionTrigger();
-        cacc_reg_model::CaccUpdateStatRegisters(0, saturation_num_perlayer_);  //stepheng.20170724
+        // In functional fast mode the delivery sequencer reports the count once the layer is truncated
+        if (!functional_fast_mode_)
+            cacc_reg_model::CaccUpdateStatRegisters(0, saturation_num_perlayer_);  //stepheng.20170724
         cacc_reg_model::CaccUpdateWorkingStatus(0,0);
         cacc_reg_model::CaccClearOpeartionEnable(cacc_register_group_0);
         cslInfo(("NV_NVDLA_cacc::CaccConsumerThread, group 0 opeartion done\n"));
@@ -121,7 +132,9 @@ void NV_NVDLA_cacc::CaccConsumerThread () {
         cacc_reg_model::CaccUpdateWorkingStatus(1,1);
         cacc_reg_model::CaccUpdateVariables(cacc_register_group_1);
         CaccHardwareLayerExecutionTrigger();
-        cacc_reg_model::CaccUpdateStatRegisters(1, saturation_num_perlayer_);  //stepheng,20170724      
+        // In functional fast mode the delivery sequencer reports the count once the layer is truncated
+        if (!functional_fast_mode_)
+            cacc_reg_model::CaccUpdateStatRegisters(1, saturation_num_perlayer_);  //stepheng,20170724      
         cacc_reg_model::CaccUpdateWorkingStatus(1,0);
         cacc_reg_model::CaccClearOpeartionEnable(cacc_register_group_1);
         cslInfo(("NV_NVDLA_cacc::CaccConsumerThread, group 1 opeartion done\n"));
@@ -534,6 +547,12 @@ void NV_NVDLA_cacc::DeliverSequencerDirectConvCommon() {
     uint8_t     atom_per_mac_cell_iter;
     sc_int<32>* prepared_sdp_atom;
     CaccConfig* cacc_config;
+    uint32_t    clip_truncate;
+    uint32_t    cacc_consumer;
+    bool        is_fast_mode_layer;
+    uint32_t    element_per_entry_group;
+    uint32_t    element_iter;
+    std::vector<int64_t> layer_assembly_data;
 
     cacc2sdp_count  = 0;
 
@@ -551,11 +570,17 @@ void NV_NVDLA_cacc::DeliverSequencerDirectConvCommon() {
     batch_num    = cacc_config->cacc_batches_ + 1;
     line_packed  = cacc_config->cacc_line_packed_;
     surf_packed  = cacc_config->cacc_surf_packed_;
+    clip_truncate = cacc_config->cacc_clip_truncate_;
+    cacc_consumer = cacc_config->cacc_consumer_;
     delete cacc_config;
 
     cslDebug((70, "WxHxC=%dx%dx%d, precision:%d, batch_num:%d, line_packed:%d, surf_packed:%d, conv_mode:%d\n",
                 cube_width, cube_height, cube_channel, precision, batch_num, line_packed, surf_packed, conv_mode));
 
+    is_fast_mode_layer = functional_fast_mode_ && DATA_FORMAT_FP16 != precision;
+    // Delivery entries holding one output atom: two rows for INT8, one for INT16
+    element_per_entry_group = DATA_FORMAT_INT8 == precision ? 2*MAC_CELL_NUM : MAC_CELL_NUM;
+
     // Evaluated
     switch (precision) {
         case DATA_FORMAT_INT8:
@@ -615,6 +640,19 @@ void NV_NVDLA_cacc::DeliverSequencerDirectConvCommon() {
         cslDebug((50, "atom_num_sent=%ld batch_atom_num=%ld\n", atom_num_sent, batch_atom_num));
         cslDebug((50, "delivery_sram_group_idx_available_=0x%x\n", delivery_sram_group_idx_available_));
         cslDebug((50, "delivery_sram_group_idx_fetched_=0x%x\n", delivery_sram_group_idx_fetched_));
+        if (is_fast_mode_layer) {
+            // Collect the untruncated sums in delivery order and free the entries right away,
+            // the layer goes to SDP after DeliverLayerNative has truncated all of it
+            for(atom_per_mac_cell_iter=0;atom_per_mac_cell_iter<atom_per_mac_cell;atom_per_mac_cell_iter++) {
+                for (element_iter = 0; element_iter < element_per_entry_group; element_iter++) {
+                    layer_assembly_data.push_back(delivery_sram_group_native_[((delivery_sram_group_idx_fetched_+atom_per_mac_cell_iter*element_per_entry_group/MAC_CELL_NUM)*round_stride_accu+element_iter)%SRAM_GROUP_SIZE]);
+                }
+                atom_num_sent++;
+            }
+            accu2sc_credit_payload.size = atom_per_mac_cell*element_per_entry_group/MAC_CELL_NUM;
+            accu2sc_credit_b_transport(&accu2sc_credit_payload, b_transport_delay_);
+            continue;
+        }
         // Each playload to SDP contains 16 32bits elements. For INT8, there are two transactions to SDP for one ouput atom
         switch (precision) {
             case DATA_FORMAT_INT8:
@@ -674,6 +712,11 @@ void NV_NVDLA_cacc::DeliverSequencerDirectConvCommon() {
         accu2sc_credit_b_transport(&accu2sc_credit_payload, b_transport_delay_);
     }
 
+    if (functional_fast_mode_) {
+        // Also reports a zero count for FP16 layers, CaccConsumerThread leaves the register alone in this mode
+        DeliverLayerNative(layer_assembly_data, clip_truncate, cacc_consumer);
+    }
+
     deliver_prev_conv_mode_ = conv_mode;
     deliver_prev_precision_ = precision;
     cslDebug((50, "NV_NVDLA_cacc::DeliverSequencerDirectConvCommon delivery_sram_group_idx_available_=0x%x\n", delivery_sram_group_idx_available_));
@@ -795,6 +838,12 @@ void NV_NVDLA_cacc::ReshapeSequencerDirectConvCommon() {
         cslDebug((50, "NV_NVDLA_cacc::ReshapeSequencerDirectConvCommon, assembly_sram_group_idx_fetched_=0x%x\n", assembly_sram_group_idx_fetched_));
         cslDebug((50, "NV_NVDLA_cacc::ReshapeSequencerDirectConvCommon, delivery_sram_group_idx_available_=0x%x\n", delivery_sram_group_idx_available_));
         cslDebug((50, "NV_NVDLA_cacc::ReshapeSequencerDirectConvCommon, before truncation\n"));
+        if (functional_fast_mode_ && DATA_FORMAT_FP16 != precision) {
+            ReshapeAtomNative(precision, atom_per_mac_cell);
+            atom_num_sent += atom_per_mac_cell;
+            delivery_sram_group_idx_available_incr_.notify();
+            continue;
+        }
         for (mac_cell_iter = 0; mac_cell_iter < MAC_CELL_NUM; mac_cell_iter ++) {
             switch (precision) {
                 case DATA_FORMAT_INT8:
@@ -1009,7 +1058,9 @@ void NV_NVDLA_cacc::mac2accu_b_transport(nvdla_mac2accu_data_concat_if_t* payloa
     cslDebug((50, "NV_NVDLA_cacc::mac2accu_b_transport, assembly_sram_group_idx_working_ is 0x%x\n", assembly_sram_group_idx_working_));
     if (assembly_sram_group_idx_working_ <= prev_layer_assembly_sram_group_idx_available_)
         FAIL(("The value of assembly_sram_group_idx_working_ is wrong. assembly_sram_group_idx_working_=0x%x prev_layer_assembly_sram_group_idx_available_=0x%x\n", assembly_sram_group_idx_working_, prev_layer_assembly_sram_group_idx_available_));
-    if (false == has_ongoing_channel_operation_) {
+    if (functional_fast_mode_ && DATA_FORMAT_FP16 != precision) {
+        AssemblyAccumulateNative(payload_data_ptr, precision, atom_per_mac_cell, false == has_ongoing_channel_operation_);
+    } else if (false == has_ongoing_channel_operation_) {
         // has_ongoing_channel_operation_ = true;
         // Start of a new output stripe, directly write mac data to ACCU
         cslDebug((50, "NV_NVDLA_cacc::mac2accu_b_transport, assembly, the first stripe of a channel operation\n"));
@@ -1239,6 +1290,105 @@ void NV_NVDLA_cacc::WaitUntilThereIsAvaliableDataInDeliveryGroup () {
     }
 }
 
+// Sign extend to the assembly SRAM width, as storing into assembly_sram_group_ does
+static inline int64_t cacc_assembly_wrap(int64_t value) {
+    return (int64_t)((uint64_t)value << (64 - ACCU_ASSEMBLY_BIT_WIDTH_INT16)) >> (64 - ACCU_ASSEMBLY_BIT_WIDTH_INT16);
+}
+
+// Functional fast mode version of the INT8/INT16 assembly in mac2accu_b_transport.
+// Same entry layout and saturation, on assembly_sram_group_native_.
+void NV_NVDLA_cacc::AssemblyAccumulateNative(sc_int<MAC_OUTPUT_BIT_WIDTH_INT8> *payload_data_ptr, uint32_t precision, uint32_t atom_per_mac_cell, bool first_stripe) {
+    uint32_t    mac_cell_iter;
+    uint32_t    atom_iter;
+    uint32_t    element_iter;
+    uint32_t    element_per_mac_cell;
+    uint32_t    entry_per_atom;
+    uint32_t    payload_idx;
+    uint32_t    assembly_idx;
+    int64_t     mac_data;
+    int64_t     sum_tmp;
+
+    // INT8 has two results per MAC cell and atom, INT16 has one 38-bit result split over two payload elements
+    element_per_mac_cell = DATA_FORMAT_INT8 == precision ? 2 : 1;
+    entry_per_atom       = DATA_FORMAT_INT8 == precision ? 2 : 1;
+    for (mac_cell_iter = 0; mac_cell_iter < MAC_CELL_NUM; mac_cell_iter ++) {
+        for (atom_iter = 0; atom_iter < atom_per_mac_cell; atom_iter ++) {
+            for (element_iter = 0; element_iter < element_per_mac_cell; element_iter ++) {
+                payload_idx  = mac_cell_iter * ELEMENT_PER_MAC_CELL_INT8 + atom_iter * 2 + element_iter;
+                assembly_idx = ((assembly_sram_group_idx_working_ + atom_iter*entry_per_atom)*MAC_CELL_NUM + mac_cell_iter*element_per_mac_cell + element_iter)%SRAM_GROUP_SIZE;
+                if (DATA_FORMAT_INT8 == precision) {
+                    mac_data = payload_data_ptr[payload_idx].to_int64();
+                } else {
+                    // {payload[idx+1], payload[idx]} truncated to 38 bits
+                    mac_data = ((uint64_t)payload_data_ptr[payload_idx+1].to_int64() << MAC_OUTPUT_BIT_WIDTH_INT8) |
+                               ((uint64_t)payload_data_ptr[payload_idx].to_int64() & ((1ULL << MAC_OUTPUT_BIT_WIDTH_INT8) - 1));
+                    mac_data = (int64_t)((uint64_t)mac_data << (64 - 38)) >> (64 - 38);
+                }
+                if (first_stripe) {
+                    assembly_sram_group_native_[assembly_idx] = cacc_assembly_wrap(mac_data);
+                } else {
+                    sum_tmp = assembly_sram_group_native_[assembly_idx] + mac_data;
+                    if (sum_tmp > MAX_INT_48BITS)
+                        sum_tmp = MAX_INT_48BITS;
+                    else if (sum_tmp < MIN_INT_48BITS)
+                        sum_tmp = MIN_INT_48BITS;
+                    assembly_sram_group_native_[assembly_idx] = cacc_assembly_wrap(sum_tmp);
+                }
+            }
+        }
+    }
+}
+
+// Functional fast mode version of the INT8/INT16 reshape in ReshapeSequencerDirectConvCommon.
+// Moves the atom at assembly_sram_group_idx_fetched_ into delivery_sram_group_idx_available_
+// untruncated, DeliverLayerNative truncates it with the rest of the layer.
+void NV_NVDLA_cacc::ReshapeAtomNative(uint32_t precision, uint32_t atom_per_mac_cell) {
+    uint32_t    atom_iter;
+    uint32_t    element_iter;
+    uint32_t    element_per_row;
+    uint32_t    entry_per_atom;
+    uint32_t    assembly_idx;
+    uint32_t    delivery_idx;
+
+    element_per_row = DATA_FORMAT_INT8 == precision ? 2*MAC_CELL_NUM : MAC_CELL_NUM;
+    entry_per_atom  = DATA_FORMAT_INT8 == precision ? 2 : 1;
+    for (atom_iter = 0; atom_iter < atom_per_mac_cell; atom_iter ++) {
+        for (element_iter = 0; element_iter < element_per_row; element_iter ++) {
+            assembly_idx = ((assembly_sram_group_idx_fetched_ + atom_iter*entry_per_atom)*MAC_CELL_NUM + element_iter)%SRAM_GROUP_SIZE;
+            delivery_idx = ((delivery_sram_group_idx_available_ + atom_iter*entry_per_atom)*MAC_CELL_NUM + element_iter)%SRAM_GROUP_SIZE;
+            delivery_sram_group_native_[delivery_idx] = assembly_sram_group_native_[assembly_idx];
+        }
+    }
+}
+
+// Functional fast mode end of layer: truncates the collected sums of the whole
+// layer on layer_executor_, reports the saturation count and queues the result
+// for SendToSDPCommon in the order the event-driven delivery would have.
+void NV_NVDLA_cacc::DeliverLayerNative(std::vector<int64_t> &assembly_data, uint32_t clip_truncate, uint32_t cacc_consumer) {
+    uint64_t    payload_num;
+    uint64_t    payload_iter;
+    uint32_t    element_iter;
+    uint64_t    saturation_num;
+    sc_int<32>* prepared_sdp_atom;
+
+    payload_num = assembly_data.size() / CACC_TO_SDP_THROUGHPUT_INT8;
+    std::vector<int32_t> delivery_data(assembly_data.size());
+    saturation_num = NvdlaCaccTruncateLayer(layer_executor_, assembly_data.data(), delivery_data.data(),
+            payload_num, CACC_TO_SDP_THROUGHPUT_INT8, clip_truncate);
+    cslDebug((50, "NV_NVDLA_cacc::DeliverLayerNative, %ld payloads on %d threads, saturation_num:%ld\n",
+                payload_num, layer_executor_.worker_num(payload_num), saturation_num));
+    cacc_reg_model::CaccUpdateStatRegisters(cacc_consumer, saturation_num);
+    assembly_data.clear();
+
+    for (payload_iter = 0; payload_iter < payload_num; payload_iter++) {
+        prepared_sdp_atom = new sc_int<32>[CACC_TO_SDP_THROUGHPUT_INT8];
+        for (element_iter = 0; element_iter < CACC_TO_SDP_THROUGHPUT_INT8; element_iter++) {
+            prepared_sdp_atom[element_iter] = delivery_data[payload_iter*CACC_TO_SDP_THROUGHPUT_INT8 + element_iter];
+        }
+        to_sdp_fifo_->write(prepared_sdp_atom);
+    }
+}
+
 // Input from cmac is FP44, the intermediate data is FP48
 void NV_NVDLA_cacc::cacc_fp16_add(sc_uint<FP16_ALEN> *fp16_accu_data, sc_uint<44> fp16_mac_data) {
     sc_uint<6>  mac_in_exp          = fp16_mac_data.range(43, 38);
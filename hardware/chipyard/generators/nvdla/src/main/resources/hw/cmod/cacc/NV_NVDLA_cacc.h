@@ -25,6 +25,8 @@
 #include "nvdla_xx2csb_resp_iface.h"
 #include "NV_NVDLA_cacc_base.h"
 #include "cacc_reg_model.h"
+#include "NvdlaLayerExecutor.h"
+#include <vector>
 
 //stepheng add cacc FP39 define.20170329
 //#define CACC_FP39
@@ -185,6 +187,15 @@ class NV_NVDLA_cacc:
         // uint8_t *delivery_sram_group_;
         sc_int<ACCU_ASSEMBLY_BIT_WIDTH_INT16> *assembly_sram_group_;
         sc_int<ACCU_DELIVERY_BIT_WIDTH_INT16> *delivery_sram_group_;
+        // Functional fast mode keeps INT8/INT16 partial sums here instead of
+        // assembly_sram_group_, and passes them untruncated through
+        // delivery_sram_group_native_. The delivery sequencer truncates the
+        // whole layer at once on layer_executor_. FP16 layers always use the
+        // sc_int groups.
+        bool    functional_fast_mode_;
+        int64_t *assembly_sram_group_native_;
+        int64_t *delivery_sram_group_native_;
+        NvdlaLayerExecutor layer_executor_;
         uint32_t *assembly_sram_group_mask_bits_;
         uint8_t *assembly_sram_group_layer_end_bit_;
         uint32_t *delivery_sram_group_mask_bits_;
@@ -250,6 +261,10 @@ class NV_NVDLA_cacc:
         void CaccSendCsbResponse(uint8_t type, uint32_t data, uint8_t error_id);
         void WaitUntilThereIsAvaliableDataInAssemblyGroup();
         void WaitUntilThereIsAvaliableDataInDeliveryGroup();
+        // # Functional fast mode datapath
+        void AssemblyAccumulateNative(sc_int<MAC_OUTPUT_BIT_WIDTH_INT8> *payload_data_ptr, uint32_t precision, uint32_t atom_per_mac_cell, bool first_stripe);
+        void ReshapeAtomNative(uint32_t precision, uint32_t atom_per_mac_cell);
+        void DeliverLayerNative(std::vector<int64_t> &assembly_data, uint32_t clip_truncate, uint32_t cacc_consumer);
         void cacc_fp16_add(sc_uint<FP16_ALEN> *fp16_accu_data, sc_uint<44> fp16_mac_data);
         void cacc_fp48_to_fp32(sc_int<32> *fp32_to_sdp, sc_uint<FP16_ALEN> fp16_accu_data);
 
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <iomanip>
+#include <string.h>
 #include "NV_NVDLA_cmac.h"
 #include "NV_NVDLA_cmac_cmac_a_gen.h"
 #include "arnvdla.uh"
@@ -46,6 +47,10 @@ NV_NVDLA_cmac::NV_NVDLA_cmac( sc_module_name module_name ):
     weight_operand_shadow_  = new sc_int<WEIGHT_OPERAND_BIT_WIDTH_INT8> [WEIGHT_ELEMENT_NUM];   // 8*128*8bit   - We have 8 MAC cells, 128B per MAC
     weight_operand_         = new sc_int<WEIGHT_OPERAND_BIT_WIDTH_INT8> [WEIGHT_ELEMENT_NUM];
     mac_result_             = new sc_int<OUTPUT_BIT_WIDTH_INT8>         [MAC_CELL_NUM * RESULT_NUM_PER_MACELL]; // 8*8*22bit - 8 MAC cells, 8 output per MAC for INT8+WG mode(worst case)
+    data_operand_i8_            = new int8_t  [DATA_ELEMENT_NUM];
+    weight_operand_shadow_i8_   = new int8_t  [WEIGHT_ELEMENT_NUM];
+    weight_operand_i8_          = new int8_t  [WEIGHT_ELEMENT_NUM];
+    mac_result_i32_             = new int32_t [MAC_CELL_NUM * RESULT_NUM_PER_MACELL];
     mac_cell_array          = new NvdlaMacCell[MAC_CELL_NUM];
 
     // Reset
@@ -60,6 +65,10 @@ NV_NVDLA_cmac::~NV_NVDLA_cmac() {
     if( weight_operand_ )  delete [] weight_operand_;
     if( data_operand_ )  delete [] data_operand_;
     if( mac_result_ )  delete [] mac_result_;
+    if( data_operand_i8_ )  delete [] data_operand_i8_;
+    if( weight_operand_shadow_i8_ )  delete [] weight_operand_shadow_i8_;
+    if( weight_operand_i8_ )  delete [] weight_operand_i8_;
+    if( mac_result_i32_ )  delete [] mac_result_i32_;
     if( mac_cell_array )  delete [] mac_cell_array;
 }
 
@@ -71,6 +80,9 @@ void NV_NVDLA_cmac::Reset() {
         mac_cell_array[mac_cell_iter].data_operand_ptr_     = data_operand_; //Each MAC CELL uses same data(128Bytes)
         mac_cell_array[mac_cell_iter].weight_operand_ptr_   = &weight_operand_[mac_cell_iter*DATA_ELEMENT_NUM];
         mac_cell_array[mac_cell_iter].result_ptr_           = &mac_result_[mac_cell_iter*RESULT_NUM_PER_MACELL];
+        mac_cell_array[mac_cell_iter].data_i8_ptr_          = data_operand_i8_;
+        mac_cell_array[mac_cell_iter].weight_i8_ptr_        = &weight_operand_i8_[mac_cell_iter*DATA_ELEMENT_NUM];
+        mac_cell_array[mac_cell_iter].result_i32_ptr_       = &mac_result_i32_[mac_cell_iter*RESULT_NUM_PER_MACELL];
     }
     // Clear register and internal states
     CmacARegReset();
@@ -137,15 +149,22 @@ void NV_NVDLA_cmac::sc2mac_wt_b_transport(int ID, nvdla_sc2mac_weight_if_t* payl
     wt_mask_shadow[mac_cell_id][0] = payload->mask[0];
     wt_mask_shadow[mac_cell_id][1] = payload->mask[1];
     for (iter = 0; iter < DATA_ELEMENT_NUM; iter ++) {  //DATA_ELEMENT_NUM=128
-        weight_operand_shadow_[mac_cell_id * DATA_ELEMENT_NUM + iter] = payload_data_ptr[iter];
+        weight_operand_shadow_i8_[mac_cell_id * DATA_ELEMENT_NUM + iter] = payload_data_ptr[iter].to_int();
+    }
+    if (cmac_a_proc_precision_ == NVDLA_CMAC_A_D_MISC_CFG_0_PROC_PRECISION_FP16) {
+        for (iter = 0; iter < DATA_ELEMENT_NUM; iter ++) {
+            weight_operand_shadow_[mac_cell_id * DATA_ELEMENT_NUM + iter] = payload_data_ptr[iter];
+        }
     }
 
-    cslDebug((70, "%s: weight before MAC on %d MAC cell:\n", __FUNCTION__, mac_cell_id));
-    for (iter = 0; iter < DATA_ELEMENT_NUM; iter ++) {  //DATA_ELEMENT_NUM=128
-        uint8_t val = weight_operand_shadow_[mac_cell_id * DATA_ELEMENT_NUM + iter].to_int();
-        cslDebug((70, "%02x", val));
+    if (cslLogEnabled(SC_DEBUG)) {
+        cslDebug((70, "%s: weight before MAC on %d MAC cell:\n", __FUNCTION__, mac_cell_id));
+        for (iter = 0; iter < DATA_ELEMENT_NUM; iter ++) {  //DATA_ELEMENT_NUM=128
+            uint8_t val = weight_operand_shadow_i8_[mac_cell_id * DATA_ELEMENT_NUM + iter];
+            cslDebug((70, "%02x", val));
+        }
+        cslDebug((70, "\n"));
     }
-    cslDebug((70, "\n"));
 
 }
 
@@ -171,17 +190,24 @@ void NV_NVDLA_cmac::sc2mac_dat_b_transport(int ID, nvdla_sc2mac_data_if_t* paylo
     // Copy data from payload to operand ptr
     csc2cmac_payload_data_ptr = payload->data;
     for (element_iter = 0; element_iter < DATA_ELEMENT_NUM; element_iter ++ ) { //DATA_ELEMENT_NUM=128
-        data_operand_[element_iter] = csc2cmac_payload_data_ptr[element_iter].range(7,0);
+        data_operand_i8_[element_iter] = csc2cmac_payload_data_ptr[element_iter].to_int();
+    }
+    if (cmac_a_proc_precision_ == NVDLA_CMAC_A_D_MISC_CFG_0_PROC_PRECISION_FP16) {
+        for (element_iter = 0; element_iter < DATA_ELEMENT_NUM; element_iter ++ ) {
+            data_operand_[element_iter] = csc2cmac_payload_data_ptr[element_iter].range(7,0);
+        }
     }
     dat_mask[0] = payload->mask[0];
     dat_mask[1] = payload->mask[1];
 
-    cslDebug((70, "%s: data before MAC:\n", __FUNCTION__));
-    for(int idx = 127; idx >= 0; idx--) {
-        uint8_t val = data_operand_[idx].to_int();
-        cslDebug((70, "%02x", val));
+    if (cslLogEnabled(SC_DEBUG)) {
+        cslDebug((70, "%s: data before MAC:\n", __FUNCTION__));
+        for(int idx = 127; idx >= 0; idx--) {
+            uint8_t val = data_operand_i8_[idx];
+            cslDebug((70, "%02x", val));
+        }
+        cslDebug((70, "\n"));
     }
-    cslDebug((70, "\n"));
 
     // Calculation
     for (mac_cell_iter=0; mac_cell_iter < MAC_CELL_NUM; mac_cell_iter++) {
@@ -193,8 +219,14 @@ void NV_NVDLA_cmac::sc2mac_dat_b_transport(int ID, nvdla_sc2mac_data_if_t* paylo
     mac2accu_payload.mask       = enabled_mac_cell_active_;
     mac2accu_payload.mode       = wino_op? 0xff: 0x00;
     cmac2cacc_payload_data_ptr  = mac2accu_payload.data;
-    for (element_iter = 0; element_iter < MAC_CELL_NUM * RESULT_NUM_PER_MACELL; element_iter ++ ) {
-        cmac2cacc_payload_data_ptr[element_iter] = mac_result_[element_iter];
+    if (cmac_a_proc_precision_ == NVDLA_CMAC_A_D_MISC_CFG_0_PROC_PRECISION_FP16) {
+        for (element_iter = 0; element_iter < MAC_CELL_NUM * RESULT_NUM_PER_MACELL; element_iter ++ ) {
+            cmac2cacc_payload_data_ptr[element_iter] = mac_result_[element_iter];
+        }
+    } else {
+        for (element_iter = 0; element_iter < MAC_CELL_NUM * RESULT_NUM_PER_MACELL; element_iter ++ ) {
+            cmac2cacc_payload_data_ptr[element_iter] = mac_result_i32_[element_iter];
+        }
     }
     mac2accu_payload.pd.nvdla_stripe_info = payload->pd.nvdla_stripe_info;
 
@@ -205,9 +237,11 @@ void NV_NVDLA_cmac::sc2mac_dat_b_transport(int ID, nvdla_sc2mac_data_if_t* paylo
     cslDebug((50, "    stripe_end is 0x%x\n",   (uint32_t)mac2accu_payload.pd.nvdla_stripe_info.stripe_end));
     cslDebug((50, "    Mask is 0x%x\n",         mac2accu_payload.mask));
     cslDebug((50, "    Mode is 0x%x\n",         mac2accu_payload.mode));
-    for (uint32_t mac_cell_idx_db=0; mac_cell_idx_db<MAC_CELL_NUM; mac_cell_idx_db ++) {
-        for (uint32_t element_idx_db=0; element_idx_db<RESULT_NUM_PER_MACELL; element_idx_db ++) {
-            cslDebug((70, "Data[0x%x,0x%x]: 0x%08llx\n", mac_cell_idx_db, element_idx_db, mac2accu_payload.data[mac_cell_idx_db * RESULT_NUM_PER_MACELL + element_idx_db].to_int64()));
+    if (cslLogEnabled(SC_DEBUG)) {
+        for (uint32_t mac_cell_idx_db=0; mac_cell_idx_db<MAC_CELL_NUM; mac_cell_idx_db ++) {
+            for (uint32_t element_idx_db=0; element_idx_db<RESULT_NUM_PER_MACELL; element_idx_db ++) {
+                cslDebug((70, "Data[0x%x,0x%x]: 0x%08llx\n", mac_cell_idx_db, element_idx_db, mac2accu_payload.data[mac_cell_idx_db * RESULT_NUM_PER_MACELL + element_idx_db].to_int64()));
+            }
         }
     }
     mac2accu_b_transport(&mac2accu_payload, b_transport_delay_);
@@ -222,8 +256,11 @@ void NV_NVDLA_cmac::sc2mac_dat_b_transport(int ID, nvdla_sc2mac_data_if_t* paylo
 void NV_NVDLA_cmac::UpdateWeightFromShadowToActive () {
     uint32_t iter;
     uint32_t mac_cell_iter;
-    for (iter = 0; iter < WEIGHT_ELEMENT_NUM; iter ++) {
-        weight_operand_[iter] = weight_operand_shadow_[iter];
+    memcpy(weight_operand_i8_, weight_operand_shadow_i8_, WEIGHT_ELEMENT_NUM);
+    if (cmac_a_proc_precision_ == NVDLA_CMAC_A_D_MISC_CFG_0_PROC_PRECISION_FP16) {
+        for (iter = 0; iter < WEIGHT_ELEMENT_NUM; iter ++) {
+            weight_operand_[iter] = weight_operand_shadow_[iter];
+        }
     }
     for (mac_cell_iter=0; mac_cell_iter < MAC_CELL_NUM; mac_cell_iter++) {
         wt_mask[mac_cell_iter][0] = wt_mask_shadow[mac_cell_iter][0];
@@ -73,6 +73,10 @@ public:
     sc_int<DATA_OPERAND_BIT_WIDTH_INT8>     *data_operand_ptr_;
     sc_int<WEIGHT_OPERAND_BIT_WIDTH_INT8>   *weight_operand_ptr_;
     sc_int<OUTPUT_BIT_WIDTH_INT8>           *result_ptr_;
+    // native copies of the operands and results for the integer datapaths
+    int8_t                                  *data_i8_ptr_;
+    int8_t                                  *weight_i8_ptr_;
+    int32_t                                 *result_i32_ptr_;
     uint64_t                                *wt_mask_ptr_;
     uint64_t                                *dat_mask_ptr_;
 
@@ -80,19 +84,32 @@ public:
     bool mac_cell_enable_;
     bool winograd_op_;
 
-    void calculation_int8(uint64_t* wt_mask, uint64_t* dat_mask, sc_int<DATA_OPERAND_BIT_WIDTH_INT8> *data_operand, sc_int<WEIGHT_OPERAND_BIT_WIDTH_INT8> *weight_operand, sc_int<OUTPUT_BIT_WIDTH_INT8> *result){
+    // The integer datapaths work on native int8_t operands and int32_t
+    // results. The sc_int arithmetic they replace wraps every intermediate
+    // to the datapath width, which is the same as doing the arithmetic
+    // natively and wrapping once at the end, so results stay bit-exact.
+    static inline int32_t sign_extend_22(int64_t value) {
+        return (int32_t)((int64_t)((uint64_t)value << (64 - OUTPUT_BIT_WIDTH_INT8)) >> (64 - OUTPUT_BIT_WIDTH_INT8));
+    }
+
+    static inline int32_t dot_product_int8(const int8_t *data, const int8_t *weight, uint64_t mask) {
+        int32_t accu = 0;
+        for (uint32_t channel_iter=0; channel_iter<PARALLEL_CHANNEL_NUM; channel_iter++) {
+            int32_t enable = (mask >> channel_iter) & 0x1;
+            accu += enable * data[channel_iter] * weight[channel_iter];
+        }
+        return accu;
+    }
+
+    static inline int16_t operand_int16(const int8_t *operand, uint32_t channel_iter) {
+        return (int16_t)(((uint8_t)operand[channel_iter*2+1] << 8) | (uint8_t)operand[channel_iter*2]);
+    }
+
+    void calculation_int8(uint64_t* wt_mask, uint64_t* dat_mask, const int8_t *data_operand, const int8_t *weight_operand, int32_t *result){
         uint32_t    channel_iter, kernel_iter, result_iter;
-        sc_int<DATA_OPERAND_BIT_WIDTH_INT8>   data;
-        sc_int<WEIGHT_OPERAND_BIT_WIDTH_INT8> weight;
-        sc_int<OUTPUT_BIT_WIDTH_INT8> product;
-        sc_int<OUTPUT_BIT_WIDTH_INT8> accu;
-        sc_int<OUTPUT_BIT_WIDTH_INT8> accu_wino_phase1[16];
-        sc_int<OUTPUT_BIT_WIDTH_INT8> accu_wino_phase2[8];
-        sc_int<OUTPUT_BIT_WIDTH_INT8> accu_wino_phase3[4];
-        int8_t wt_mask_k0;
-        int8_t wt_mask_k1;
-        int8_t dat_mask_k0;
-        int8_t dat_mask_k1;
+        int32_t     accu_wino_phase1[16];
+        int32_t     accu_wino_phase2[8];
+        int32_t     accu_wino_phase3[4];
 
         for (result_iter=0; result_iter < RESULT_NUM_PER_MACELL; result_iter++) {
              result[result_iter] = 0;
@@ -135,11 +152,9 @@ public:
                     for (i=0; i<16; i++) {
                         accu_wino_phase1[i]   = 0;
                         for (channel_iter=0; channel_iter<4; channel_iter++) {
-                            data   = data_operand[kernel_iter*64+i*4+channel_iter];
-                            weight = weight_operand[kernel_iter*64+i*4+channel_iter];
-                            accu_wino_phase1[i] = accu_wino_phase1[i] + data * weight;
+                            accu_wino_phase1[i] += data_operand[kernel_iter*64+i*4+channel_iter] * weight_operand[kernel_iter*64+i*4+channel_iter];
                         }
-                        cslDebug((70, "    calculation_int8 winograd kernel_iter=%d accu_wino_phase1[%d] = 0x%x\n", kernel_iter, i, (uint32_t)accu_wino_phase1[i].to_int()));
+                        cslDebug((70, "    calculation_int8 winograd kernel_iter=%d accu_wino_phase1[%d] = 0x%x\n", kernel_iter, i, (uint32_t)sign_extend_22(accu_wino_phase1[i])));
                     }
                     // Phase2: multiply transposition of matrix A. Generate 8 parital sums.
                     for (i=0; i<4; i++) {
@@ -151,76 +166,54 @@ public:
                         accu_wino_phase3[i*2+0] = accu_wino_phase2[i*4+0] + accu_wino_phase2[i*4+1] + accu_wino_phase2[i*4+2];
                         accu_wino_phase3[i*2+1] = accu_wino_phase2[i*4+1] - accu_wino_phase2[i*4+2] - accu_wino_phase2[i*4+3];
                     }
-                    result[kernel_iter+0] = accu_wino_phase3[0];
-                    result[kernel_iter+2] = accu_wino_phase3[1];
-                    result[kernel_iter+4] = accu_wino_phase3[2];
-                    result[kernel_iter+6] = accu_wino_phase3[3];
+                    result[kernel_iter+0] = sign_extend_22(accu_wino_phase3[0]);
+                    result[kernel_iter+2] = sign_extend_22(accu_wino_phase3[1]);
+                    result[kernel_iter+4] = sign_extend_22(accu_wino_phase3[2]);
+                    result[kernel_iter+6] = sign_extend_22(accu_wino_phase3[3]);
                 }
                 for(int i=0;i<8;i++)
-                    cslDebug((70, "    calculation_int8 winograd result = 0x%x\n", (uint32_t)result[i].to_int()));
+                    cslDebug((70, "    calculation_int8 winograd result = 0x%x\n", (uint32_t)result[i]));
             }
             else {
+                // kernel 0 uses the upper mask words, kernel 1 the lower ones
                 for(kernel_iter=0; kernel_iter<2; kernel_iter++) {
-                    accu = 0;
-                    cslDebug((70, "    kernel_iter  is 0x%x\n", kernel_iter));
-                    for (channel_iter=0; channel_iter<PARALLEL_CHANNEL_NUM; channel_iter++) {
-                        data   = data_operand[kernel_iter*PARALLEL_CHANNEL_NUM+channel_iter];
-                        weight = weight_operand[kernel_iter*PARALLEL_CHANNEL_NUM+channel_iter];
-                        cslDebug((70, "    channel_iter is 0x%x\n", channel_iter));
-                        cslDebug((70, "    Data        : 0x%02x\n", (uint8_t)data));
-                        cslDebug((70, "    Weight      : 0x%02x\n", (uint8_t)weight));
-                        if (kernel_iter==0) {
-                            wt_mask_k0  = (wt_mask[1] >> channel_iter) & 0x1;
-                            dat_mask_k0 = (dat_mask[1] >> channel_iter) & 0x1;
-                            cslDebug((70, "    dat_mask_k0 : %d\n", dat_mask_k0));
-                            cslDebug((70, "    wt_mask_k0  : %d\n", wt_mask_k0));
-                            if((wt_mask_k0 == 0) || (dat_mask_k0 == 0))
+                    uint64_t mask = wt_mask[1-kernel_iter] & dat_mask[1-kernel_iter];
+                    const int8_t *data = &data_operand[kernel_iter*PARALLEL_CHANNEL_NUM];
+                    const int8_t *weight = &weight_operand[kernel_iter*PARALLEL_CHANNEL_NUM];
+                    int32_t accu = dot_product_int8(data, weight, mask);
+                    if (cslLogEnabled(SC_DEBUG)) {
+                        int32_t partial = 0;
+                        cslDebug((70, "    kernel_iter  is 0x%x\n", kernel_iter));
+                        for (channel_iter=0; channel_iter<PARALLEL_CHANNEL_NUM; channel_iter++) {
+                            cslDebug((70, "    channel_iter is 0x%x\n", channel_iter));
+                            cslDebug((70, "    Data        : 0x%02x\n", (uint8_t)data[channel_iter]));
+                            cslDebug((70, "    Weight      : 0x%02x\n", (uint8_t)weight[channel_iter]));
+                            if (((mask >> channel_iter) & 0x1) == 0)
                                 continue;
+                            partial += data[channel_iter] * weight[channel_iter];
+                            cslDebug((70, "    product    : 0x%x\n", (uint32_t)sign_extend_22(data[channel_iter] * weight[channel_iter])));
+                            cslDebug((70, "    accu       : 0x%x\n", (uint32_t)sign_extend_22(partial)));
                         }
-                        else {
-                            wt_mask_k1  = (wt_mask[0] >> channel_iter) & 0x1;
-                            dat_mask_k1 = (dat_mask[0] >> channel_iter) & 0x1;
-                            cslDebug((70, "    dat_mask_k1 : %d\n", dat_mask_k1));
-                            cslDebug((70, "    wt_mask_k1  : %d\n", wt_mask_k1));
-                            if((wt_mask_k1 == 0) || (dat_mask_k1 == 0))
-                                continue;
-                        }
-                        //accu  = accu + data * weight;
-                        product = data * weight;
-                        accu    = accu + product;
-                        cslDebug((70, "    product    : 0x%x\n", (uint32_t)product));
-                        cslDebug((70, "    accu       : 0x%x\n", (uint32_t)accu));
                     }
-                    result[kernel_iter] = accu; // save to index 0 and 4 of result array which contains 8 elements
-                    cslDebug((70, "    calculation_int8 result = 0x%x\n", (uint32_t)accu.to_int()));
+                    result[kernel_iter] = sign_extend_22(accu); // save to index 0 and 4 of result array which contains 8 elements
+                    cslDebug((70, "    calculation_int8 result = 0x%x\n", (uint32_t)result[kernel_iter]));
                 }
             }
         }
     }
 
-    void calculation_int16(uint64_t* wt_mask, uint64_t* dat_mask, sc_int<DATA_OPERAND_BIT_WIDTH_INT8> *data_operand, sc_int<WEIGHT_OPERAND_BIT_WIDTH_INT8> *weight_operand, sc_int<OUTPUT_BIT_WIDTH_INT8> *result){
-        sc_int<DATA_OPERAND_BIT_WIDTH_INT16>   data;
-        sc_int<WEIGHT_OPERAND_BIT_WIDTH_INT16> weight;
-        sc_int<OUTPUT_BIT_WIDTH_INT16> accu;
-        sc_int<OUTPUT_BIT_WIDTH_INT16> accu_wino_phase1[16];
-        sc_int<OUTPUT_BIT_WIDTH_INT16> accu_wino_phase2[8];
-        sc_int<OUTPUT_BIT_WIDTH_INT16> accu_wino_phase3[4];
+    void calculation_int16(uint64_t* wt_mask, uint64_t* dat_mask, const int8_t *data_operand, const int8_t *weight_operand, int32_t *result){
+        int64_t     accu;
+        int64_t     accu_wino_phase1[16];
+        int64_t     accu_wino_phase2[8];
+        int64_t     accu_wino_phase3[4];
         uint32_t    channel_iter, result_iter;
         int         i;
-        int16_t     data_array[4][4][4], weight_array[4][4][4];
         for (result_iter=0; result_iter < RESULT_NUM_PER_MACELL; result_iter++) {
              result[result_iter] = 0;
         }
 
-        for(int c = 0; c < 4; c++) {
-            for(int y = 0; y < 4; y++) {
-                for(int x = 0; x < 4; x++) {
-                    data_array[c][y][x] = (data_operand[(y*4+x)*8+c*2+1].range(7,0), data_operand[(y*4+x)*8+c*2].range(7,0));
-                    weight_array[c][y][x]= (weight_operand[(y*4+x)*8+c*2+1], weight_operand[(y*4+x)*8+c*2]);
-                }
-            }
-        }
-        cslDebug((30, "data:%d, weight:%d\n", data_array[0][0][0], weight_array[0][0][0]));
+        cslDebug((30, "data:%d, weight:%d\n", operand_int16(data_operand, 0), operand_int16(weight_operand, 0)));
 
         cslDebug((50, "Calculation_int16: mac_cell_enable_ is %s\n", mac_cell_enable_? "true": "false"));
         cslDebug((50, "    wt_mask[0]  : 0x%016lx\n", wt_mask[0]));
@@ -233,9 +226,7 @@ public:
                 for (i=0; i<16; i++) {
                     accu_wino_phase1[i]   = 0;
                     for (channel_iter=0; channel_iter<4; channel_iter++) {
-                        data   = (data_operand[i*8+channel_iter*2+1].range(7,0), data_operand[i*8+channel_iter*2].range(7,0));
-                        weight = (weight_operand[i*8+channel_iter*2+1], weight_operand[i*8+channel_iter*2]);
-                        accu_wino_phase1[i] = accu_wino_phase1[i] + data * weight;
+                        accu_wino_phase1[i] += (int64_t)operand_int16(data_operand, i*4+channel_iter) * operand_int16(weight_operand, i*4+channel_iter);
                     }
                 }
                 // Phase2: multiply transposition of matrix A. Generate 8 parital sums.
@@ -248,51 +239,54 @@ public:
                     accu_wino_phase3[i*2+0] = accu_wino_phase2[i*4+0] + accu_wino_phase2[i*4+1] + accu_wino_phase2[i*4+2];
                     accu_wino_phase3[i*2+1] = accu_wino_phase2[i*4+1] - accu_wino_phase2[i*4+2] - accu_wino_phase2[i*4+3];
                 }
-                (result[1], result[0]) = accu_wino_phase3[0];
-                (result[3], result[2]) = accu_wino_phase3[1];
-                (result[5], result[4]) = accu_wino_phase3[2];
-                (result[7], result[6]) = accu_wino_phase3[3];
+                // Each 44-bit sum is split across two 22-bit results
+                for (i=0; i<4; i++) {
+                    result[i*2+0] = sign_extend_22(accu_wino_phase3[i]);
+                    result[i*2+1] = sign_extend_22(accu_wino_phase3[i] >> OUTPUT_BIT_WIDTH_INT8);
+                }
             }
             else {
-                accu   = 0;
+                // Each 16-bit channel occupies two adjacent mask bits, which
+                // must agree. Channels 0-31 use the upper mask words.
+                uint64_t mask = 0;
                 for (channel_iter=0; channel_iter<PARALLEL_CHANNEL_NUM; channel_iter++) {
-                    data   = (data_operand[channel_iter*2+1].range(7,0), data_operand[channel_iter*2].range(7,0));
-                    weight = (weight_operand[channel_iter*2+1], weight_operand[channel_iter*2]);
-                    if (channel_iter<32) {
-                        if (((wt_mask[1] >> (channel_iter*2)) & 0x1) != ((wt_mask[1] >> (channel_iter*2 + 1)) & 0x1))
-                            FAIL(("Incorrect wt_mask[1]\n")); 
-                        if (((dat_mask[1] >> (channel_iter*2)) & 0x1) != ((dat_mask[1] >> (channel_iter*2 + 1)) & 0x1))
-                            FAIL(("Incorrect dat_mask[1]\n")); 
-                        if(((wt_mask[1] >> (channel_iter*2)) & 0x1) == 0) {
-                            if(weight!=0)
-                                FAIL(("Incorrect weight and wt_mask[1]\n"));
-                            continue;
-                        }
-                        if(((dat_mask[1] >> (channel_iter*2)) & 0x1) == 0) {
-                            continue;
-                        }
+                    uint64_t wt_word  = channel_iter<32 ? wt_mask[1]  : wt_mask[0];
+                    uint64_t dat_word = channel_iter<32 ? dat_mask[1] : dat_mask[0];
+                    uint32_t bit = (channel_iter % 32) * 2;
+                    if (((wt_word >> bit) & 0x1) != ((wt_word >> (bit + 1)) & 0x1))
+                        FAIL(("Incorrect wt_mask[%d]\n", channel_iter<32 ? 1 : 0));
+                    if (((dat_word >> bit) & 0x1) != ((dat_word >> (bit + 1)) & 0x1))
+                        FAIL(("Incorrect dat_mask[%d]\n", channel_iter<32 ? 1 : 0));
+                    if (((wt_word >> bit) & 0x1) == 0) {
+                        if (operand_int16(weight_operand, channel_iter) != 0)
+                            FAIL(("Incorrect weight and wt_mask[%d]\n", channel_iter<32 ? 1 : 0));
+                        continue;
                     }
-                    else {
-                        if (((wt_mask[0] >> ((channel_iter-32)*2)) & 0x1) != ((wt_mask[0] >> ((channel_iter-32)*2 + 1)) & 0x1))
-                            FAIL(("Incorrect wt_mask[0]\n")); 
-                        if (((dat_mask[0] >> ((channel_iter-32)*2)) & 0x1) != ((dat_mask[0] >> ((channel_iter-32)*2 + 1)) & 0x1))
-                            FAIL(("Incorrect dat_mask[0]\n")); 
-                        if(((wt_mask[0] >> ((channel_iter-32)*2)) & 0x1) == 0) {
-                            if(weight!=0)
-                                FAIL(("Incorrect weight and wt_mask[0]\n"));
-                            continue;
-                        }
-                        if(((dat_mask[0] >> ((channel_iter-32)*2)) & 0x1) == 0) {
+                    if (((dat_word >> bit) & 0x1) == 0) {
+                        continue;
+                    }
+                    mask |= 1ULL << channel_iter;
+                }
+
+                accu = 0;
+                for (channel_iter=0; channel_iter<PARALLEL_CHANNEL_NUM; channel_iter++) {
+                    int64_t enable = (mask >> channel_iter) & 0x1;
+                    accu += enable * operand_int16(data_operand, channel_iter) * operand_int16(weight_operand, channel_iter);
+                }
+                if (cslLogEnabled(SC_DEBUG)) {
+                    int64_t partial = 0;
+                    for (channel_iter=0; channel_iter<PARALLEL_CHANNEL_NUM; channel_iter++) {
+                        if (((mask >> channel_iter) & 0x1) == 0)
                             continue;
-                        }
+                        partial += (int64_t)operand_int16(data_operand, channel_iter) * operand_int16(weight_operand, channel_iter);
+                        cslDebug((70, "    channel_iter is 0x%x\n", channel_iter));
+                        cslDebug((70, "    Data        : 0x%x\n", (uint32_t)operand_int16(data_operand, channel_iter)));
+                        cslDebug((70, "    Weight      : 0x%x\n", (uint32_t)operand_int16(weight_operand, channel_iter)));
+                        cslDebug((70, "    accu       : 0x%lx\n", (uint64_t)((int64_t)((uint64_t)partial << (64 - OUTPUT_BIT_WIDTH_INT16)) >> (64 - OUTPUT_BIT_WIDTH_INT16))));
                     }
-                    accu = accu + data * weight;
-                    cslDebug((70, "    channel_iter is 0x%x\n", channel_iter));
-                    cslDebug((70, "    Data        : 0x%x\n", (uint32_t)data));
-                    cslDebug((70, "    Weight      : 0x%x\n", (uint32_t)weight));
-                    cslDebug((70, "    accu       : 0x%lx\n", (uint64_t)accu));
                 }
-                (result[1], result[0]) = accu;
+                result[0] = sign_extend_22(accu);
+                result[1] = sign_extend_22(accu >> OUTPUT_BIT_WIDTH_INT8);
                 cslDebug((70, "    calculation_int16 result[0] = 0x%x result[1] = 0x%x\n", (uint32_t)result[0], (uint32_t)result[1]));
             }
         }
@@ -839,10 +833,10 @@ public:
         winograd_op_     = wino_op;
         switch (precision_) {
             case NVDLA_CMAC_A_D_MISC_CFG_0_PROC_PRECISION_INT8:
-                calculation_int8(wt_mask_ptr_, dat_mask_ptr_, data_operand_ptr_, weight_operand_ptr_, result_ptr_);
+                calculation_int8(wt_mask_ptr_, dat_mask_ptr_, data_i8_ptr_, weight_i8_ptr_, result_i32_ptr_);
                 break;
             case NVDLA_CMAC_A_D_MISC_CFG_0_PROC_PRECISION_INT16:
-                calculation_int16(wt_mask_ptr_, dat_mask_ptr_, data_operand_ptr_, weight_operand_ptr_, result_ptr_);
+                calculation_int16(wt_mask_ptr_, dat_mask_ptr_, data_i8_ptr_, weight_i8_ptr_, result_i32_ptr_);
                 break;
             case NVDLA_CMAC_A_D_MISC_CFG_0_PROC_PRECISION_FP16:
                 calculation_fp16(wt_mask_ptr_, dat_mask_ptr_, data_operand_ptr_, weight_operand_ptr_, result_ptr_);
@@ -877,6 +871,12 @@ class NV_NVDLA_cmac:
         sc_int<WEIGHT_OPERAND_BIT_WIDTH_INT8>   *weight_operand_;
         sc_int<DATA_OPERAND_BIT_WIDTH_INT8>     *data_operand_;
         sc_int<OUTPUT_BIT_WIDTH_INT8>           *mac_result_;
+        // INT8/INT16 layers run on these native buffers; the sc_int ones
+        // above are only filled for FP16
+        int8_t                                  *weight_operand_shadow_i8_;
+        int8_t                                  *weight_operand_i8_;
+        int8_t                                  *data_operand_i8_;
+        int32_t                                 *mac_result_i32_;
         uint64_t                                 wt_mask[MAC_CELL_NUM][2];
         uint64_t                                 wt_mask_shadow[MAC_CELL_NUM][2];
         uint64_t                                 dat_mask[2];
@@ -346,9 +346,10 @@ void NV_NVDLA_SDP_CORE_x (
          )
 {
         
-        static ac_channel<xAluOutStruct> chn_alu_out;
-        static ac_channel<xMulOutStruct> chn_mul_out;
-        static ac_channel<xDataOutStruct> chn_trt_out;
+        // Per host thread, the cmod functional fast mode runs SDP layers on several threads
+        static thread_local ac_channel<xAluOutStruct> chn_alu_out;
+        static thread_local ac_channel<xMulOutStruct> chn_mul_out;
+        static thread_local ac_channel<xDataOutStruct> chn_trt_out;
         X_alu (
                   chn_data_in
                  ,chn_alu_op
@@ -62,9 +62,10 @@ void NV_NVDLA_SDP_CORE_Y_top (
          ,ac_channel<yDataOutStruct> & chn_data_out
          )
 {
-        static ac_channel<eDataOutStruct> chn_alu_op;
-        static ac_channel<eDataOutStruct> chn_mul_op;
-        static ac_channel<yDataOutStruct> chn_lut_in;
+        // Per host thread, the cmod functional fast mode runs SDP layers on several threads
+        static thread_local ac_channel<eDataOutStruct> chn_alu_op;
+        static thread_local ac_channel<eDataOutStruct> chn_mul_op;
+        static thread_local ac_channel<yDataOutStruct> chn_lut_in;
 
         
         if (cfg_mul_src==SDP_MUL_SRC_DMA && (!cfg_mul_bypass) ) {
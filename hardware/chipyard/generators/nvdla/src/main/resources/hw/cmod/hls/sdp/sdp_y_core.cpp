@@ -269,7 +269,8 @@ void NV_NVDLA_SDP_CORE_Y_core (
             cslDebug((30, "\n"));
         #endif
 
-        static ac_channel<yDataOutStruct>  chn_mul_out;
+        // Per host thread, the cmod functional fast mode runs SDP layers on several threads
+        static thread_local ac_channel<yDataOutStruct>  chn_mul_out;
 
         Y_mul ( chn_data_in, chn_mul_op,  cfg_mul_bypass, cfg_mul_prelu, cfg_mul_src, cfg_mul_op, cfg_truncate, cfg_precision, chn_mul_out);
 
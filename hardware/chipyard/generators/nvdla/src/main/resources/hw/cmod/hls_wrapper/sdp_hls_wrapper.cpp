@@ -25,7 +25,7 @@ void sdp_hls_wrapper::sdp_x(bool is_x1, int32_t *sdp_data_in, int16_t *sdp_alu_o
 {
     int i;
 // Input data
-    static int hls_call_iter = 1;
+    static thread_local int hls_call_iter = 1;
     ac_channel<xDataInStruct> chn_data_in;
     ac_channel<xAluOpStruct> chn_alu_op;
     ac_channel<xMulOpStruct> chn_mul_op;
@@ -65,9 +65,9 @@ void sdp_hls_wrapper::sdp_x(bool is_x1, int32_t *sdp_data_in, int16_t *sdp_alu_o
             ,sdp_cfg_nan_to_zero
             ,sdp_cfg_proc_precision
 
-            ,sdp_x_data_out
+            ,chn_data_out
             );
-    xDataOutStruct x_data_out = sdp_x_data_out.read();
+    xDataOutStruct x_data_out = chn_data_out.read();
     for (i=0; i<16; i++) {
         sdp_data[i] = x_data_out.data[i].to_int();
     }
@@ -126,6 +126,22 @@ void sdp_hls_wrapper::reset_stats_regs()
     o_nan_cnt    = 0;
 }
 
+// Adds the statistics of another wrapper that ran part of the same layer
+void sdp_hls_wrapper::merge_stats_regs(const sdp_hls_wrapper &other)
+{
+    total_num  += other.total_num;
+    lut_o_flow += other.lut_o_flow;
+    lut_u_flow += other.lut_u_flow;
+    lut_le_hit += other.lut_le_hit;
+    lut_lo_hit += other.lut_lo_hit;
+    lut_hybrid_hit += other.lut_hybrid_hit;
+    o_cvt_o_flow += other.o_cvt_o_flow;
+    o_cvt_u_flow += other.o_cvt_u_flow;
+    i_nan_cnt    += other.i_nan_cnt;
+    i_inf_cnt    += other.i_inf_cnt;
+    o_nan_cnt    += other.o_nan_cnt;
+}
+
 uint16_t sdp_hls_wrapper::read_lut(uint32_t tbl_id, uint32_t addr)
 {
     if (tbl_id == NVDLA_SDP_S_LUT_ACCESS_CFG_0_LUT_TABLE_ID_LE) {
@@ -162,8 +178,8 @@ void sdp_hls_wrapper::sdp_y(int32_t *sdp_data_in, int16_t *sdp_alu_op, int16_t *
 {
     int i;
     // Input data
-    static int hls_core_y_iter = 1;
-    static int hls_core_y_inp_iter = 1;
+    static thread_local int hls_core_y_iter = 1;
+    static thread_local int hls_core_y_inp_iter = 1;
     ac_channel<yDataInStruct> chn_data_in;
     ac_channel<eDataInStruct> chn_alu_op;
     ac_channel<eDataInStruct> chn_mul_op;
@@ -464,7 +480,7 @@ void sdp_hls_wrapper::sdp_y(int32_t *sdp_data_in, int16_t *sdp_alu_op, int16_t *
 void sdp_hls_wrapper::sdp_c(ac_channel<cDataInStruct> & chn_in)
 {
     int i;
-    static int hls_core_c_iter = 1;
+    static thread_local int hls_core_c_iter = 1;
 // Output Data
     ac_channel<cDataOutStruct> chn_out;
     cDataInStruct in = chn_in.read();
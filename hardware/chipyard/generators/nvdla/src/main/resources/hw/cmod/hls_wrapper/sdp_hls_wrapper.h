@@ -41,6 +41,7 @@ public:
     uint16_t read_lut(uint32_t tbl_id, uint32_t addr);
     void write_lut(uint32_t tbl_id, uint32_t addr, uint16_t val);
     void reset_stats_regs();
+    void merge_stats_regs(const sdp_hls_wrapper &other);
 
 public:
     // For ALL
@@ -107,7 +108,6 @@ public:
     bool      sdp_cfg_y_lut_out_sel_hybrid;
     bool      sdp_cfg_y_lut_out_sel_u_miss;
     bool      sdp_cfg_y_lut_out_sel_o_miss;
-    ac_channel<xDataOutStruct>  sdp_x_data_out;
     int16_t     sdp_cfg_y_le_uflow_scale;
     int8_t      sdp_cfg_y_le_uflow_shift;
     int16_t     sdp_cfg_y_le_oflow_scale;
@@ -0,0 +1,71 @@
+// ================================================================
+// NVDLA Open Source Project
+//
+// Copyright(c) 2016 - 2017 NVIDIA Corporation.  Licensed under the
+// NVDLA Open Hardware License; Check "LICENSE" which comes with
+// this distribution for more information.
+// ================================================================
+
+// File Name: NvdlaLayerExecutor.h
+
+#ifndef _NVDLALAYEREXECUTOR_H_
+#define _NVDLALAYEREXECUTOR_H_
+
+#include <inttypes.h>
+#include <thread>
+#include <vector>
+
+// Layers smaller than this many atoms per extra thread run on fewer threads
+#define LAYER_EXECUTOR_MIN_ATOM_PER_THREAD  256
+
+// Functional fast mode is selected per run: NVDLA_CMOD_FAST_MODE=1 enables it,
+// NVDLA_CMOD_FAST_MODE_THREADS=<n> limits the host threads (default: all cores)
+bool     NvdlaFunctionalFastModeEnabled();
+uint32_t NvdlaFunctionalFastModeThreadNum();
+
+// Runs a kernel over all atoms of a hardware layer on host threads. The
+// atoms are split into contiguous ranges, one per thread; in direct
+// convolution order those are runs of output channel surfaces. This class
+// has no SystemC dependency, the caller must not wait() inside a kernel.
+class NvdlaLayerExecutor {
+    public:
+        NvdlaLayerExecutor (uint32_t thread_num = 1) {
+            set_thread_num(thread_num);
+        };
+        ~NvdlaLayerExecutor (){};
+        void        set_thread_num  (uint32_t thread_num) {
+            thread_num_ = thread_num > 0 ? thread_num : 1;
+        };
+        // Number of workers run() uses for a layer of atom_num atoms
+        uint32_t    worker_num      (uint64_t atom_num) const;
+        // Calls kernel(worker_iter, atom_begin, atom_end) for every worker and
+        // returns when all of them are done. Worker 0 runs on the caller's thread.
+        template <typename T_KERNEL>
+        void        run             (uint64_t atom_num, T_KERNEL kernel) const;
+    private:
+        uint32_t thread_num_;
+};
+
+template <typename T_KERNEL>
+void NvdlaLayerExecutor::run (uint64_t atom_num, T_KERNEL kernel) const {
+    uint32_t worker_iter;
+    uint32_t worker_total = worker_num(atom_num);
+    std::vector<std::thread> workers;
+
+    for (worker_iter = 1; worker_iter < worker_total; worker_iter++) {
+        workers.push_back(std::thread(kernel, worker_iter,
+                    atom_num * worker_iter / worker_total,
+                    atom_num * (worker_iter + 1) / worker_total));
+    }
+    kernel(0, (uint64_t)0, atom_num / worker_total);
+    for (worker_iter = 0; worker_iter < workers.size(); worker_iter++) {
+        workers[worker_iter].join();
+    }
+}
+
+// CACC truncation of a layer of 48-bit assembly sums to the 32-bit SDP input,
+// rounding half away from zero and saturating. Returns the saturation count.
+uint64_t NvdlaCaccTruncateLayer(const NvdlaLayerExecutor &executor, const int64_t *assembly_data, int32_t *delivery_data,
+        uint64_t atom_num, uint32_t element_per_atom, uint32_t clip_truncate);
+
+#endif
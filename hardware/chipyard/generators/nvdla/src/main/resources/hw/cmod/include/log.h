@@ -21,24 +21,32 @@
 #include <cstdlib> // for std::abort()
 #endif
 
-// FIXME: there're 2 strrchr, might not good for performance;
 #define __FILENAME__ (strrchr(__FILE__, '/') ? (strrchr(__FILE__, '/') + 1):__FILE__)
 #define MSG_BUF_SIZE    2048
 
-#define cslDebugInternal(lvl, ...)          do {\
-                                                char msg_buf[MSG_BUF_SIZE]; \
-                                                int pos = snprintf(msg_buf, MSG_BUF_SIZE, "%d:", __LINE__); \
-                                                snprintf(msg_buf + pos, MSG_BUF_SIZE - pos, __VA_ARGS__); \
-                                                SC_REPORT_INFO_VERB(__FILENAME__, msg_buf, SC_DEBUG ); \
+// Messages more verbose than CSL_LOG_MAX_VERBOSITY are compiled out (the
+// default keeps everything). Enabled messages are checked against the
+// SystemC verbosity level before anything is formatted, so a filtered-out
+// message costs one comparison and its arguments are not evaluated.
+#ifndef CSL_LOG_MAX_VERBOSITY
+#define CSL_LOG_MAX_VERBOSITY   500 // SC_DEBUG
+#endif
+#define cslLogEnabled(verbosity)            ((int)(CSL_LOG_MAX_VERBOSITY) >= (int)(verbosity) && \
+                                             sc_core::sc_report_handler::get_verbosity_level() >= (verbosity))
+
+#define cslLogInternal(verbosity, ...)      do {\
+                                                if (cslLogEnabled(verbosity)) { \
+                                                    char msg_buf[MSG_BUF_SIZE]; \
+                                                    int pos = snprintf(msg_buf, MSG_BUF_SIZE, "%d:", __LINE__); \
+                                                    snprintf(msg_buf + pos, MSG_BUF_SIZE - pos, __VA_ARGS__); \
+                                                    sc_core::sc_report_handler::report(sc_core::SC_INFO, __FILENAME__, msg_buf, verbosity, __FILE__, __LINE__); \
+                                                } \
                                             } while(0)
+
+#define cslDebugInternal(lvl, ...)          cslLogInternal(SC_DEBUG, __VA_ARGS__)
 #define cslDebug(args)                      cslDebugInternal args
 
-#define cslInfoInternal(...)                do {\
-                                                char msg_buf[MSG_BUF_SIZE]; \
-                                                int pos = snprintf(msg_buf, MSG_BUF_SIZE, "%d:", __LINE__); \
-                                                snprintf(msg_buf + pos, MSG_BUF_SIZE - pos, __VA_ARGS__); \
-                                                SC_REPORT_INFO_VERB(__FILENAME__, msg_buf, SC_FULL ); \
-                                            } while(0)
+#define cslInfoInternal(...)                cslLogInternal(SC_FULL, __VA_ARGS__)
 #define cslInfo(args)                       cslInfoInternal args
 
 #define FAILInternal(...)                   do {\
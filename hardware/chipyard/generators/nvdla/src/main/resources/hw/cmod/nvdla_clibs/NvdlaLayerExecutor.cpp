@@ -0,0 +1,75 @@
+// ================================================================
+// NVDLA Open Source Project
+//
+// Copyright(c) 2016 - 2017 NVIDIA Corporation.  Licensed under the
+// NVDLA Open Hardware License; Check "LICENSE" which comes with
+// this distribution for more information.
+// ================================================================
+
+// File Name: NvdlaLayerExecutor.cpp
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+#include "NvdlaLayerExecutor.h"
+
+bool NvdlaFunctionalFastModeEnabled() {
+    const char *fast_mode_env = getenv("NVDLA_CMOD_FAST_MODE");
+    return fast_mode_env != NULL && atoi(fast_mode_env) != 0;
+}
+
+uint32_t NvdlaFunctionalFastModeThreadNum() {
+    const char *thread_num_env = getenv("NVDLA_CMOD_FAST_MODE_THREADS");
+    int thread_num = thread_num_env != NULL ? atoi(thread_num_env) : 0;
+    if (thread_num <= 0) {
+        thread_num = std::thread::hardware_concurrency();
+    }
+    return thread_num > 0 ? thread_num : 1;
+}
+
+uint32_t NvdlaLayerExecutor::worker_num (uint64_t atom_num) const {
+    uint64_t worker_max = atom_num / LAYER_EXECUTOR_MIN_ATOM_PER_THREAD;
+    if (worker_max < 1)
+        worker_max = 1;
+    return worker_max < thread_num_ ? worker_max : thread_num_;
+}
+
+// Same rounding as the event-driven reshape sequencer, which divides by
+// 2^clip_truncate in double and rounds half away from zero. Assembly values
+// are at most 48 bits wide, so the double computation is exact there.
+static inline int64_t cacc_round_shift(int64_t value, uint32_t clip_truncate) {
+    int64_t half = clip_truncate ? (int64_t)1 << (clip_truncate - 1) : 0;
+    return value > 0 ? (value + half) >> clip_truncate : -((half - value) >> clip_truncate);
+}
+
+uint64_t NvdlaCaccTruncateLayer(const NvdlaLayerExecutor &executor, const int64_t *assembly_data, int32_t *delivery_data,
+        uint64_t atom_num, uint32_t element_per_atom, uint32_t clip_truncate) {
+    // Per-worker counts, summed below. Saturation is counted per element, so the sum does not depend on the split.
+    std::vector<uint64_t> saturation_num(executor.worker_num(atom_num), 0);
+    uint64_t saturation_total = 0;
+    uint32_t worker_iter;
+
+    executor.run(atom_num, [&](uint32_t worker, uint64_t atom_begin, uint64_t atom_end) {
+        uint64_t element_iter;
+        uint64_t saturation_local = 0;
+        int64_t  truncated_result;
+        for (element_iter = atom_begin * element_per_atom; element_iter < atom_end * element_per_atom; element_iter++) {
+            truncated_result = cacc_round_shift(assembly_data[element_iter], clip_truncate);
+            if (truncated_result > (int64_t)INT32_MAX) {
+                delivery_data[element_iter] = INT32_MAX;
+                saturation_local++;
+            } else if (truncated_result < (int64_t)INT32_MIN) {
+                delivery_data[element_iter] = INT32_MIN;
+                saturation_local++;
+            } else {
+                delivery_data[element_iter] = (int32_t)truncated_result;
+            }
+        }
+        saturation_num[worker] = saturation_local;
+    });
+    for (worker_iter = 0; worker_iter < saturation_num.size(); worker_iter++) {
+        saturation_total += saturation_num[worker_iter];
+    }
+    return saturation_total;
+}
@@ -96,6 +96,8 @@ NV_NVDLA_sdp::NV_NVDLA_sdp( sc_module_name module_name ):
     payload_index_                  = 0;
     is_mc_ack_done_                 = false;
     is_cv_ack_done_                 = false;
+    functional_fast_mode_           = NvdlaFunctionalFastModeEnabled();
+    layer_executor_.set_thread_num(NvdlaFunctionalFastModeThreadNum());
 
     // Reset
     Reset();
@@ -150,6 +152,9 @@ void NV_NVDLA_sdp::Reset()
 
     sdp2glb_done_intr[0].initialize(false);
     sdp2glb_done_intr[1].initialize(false);
+    if (functional_fast_mode_) {
+        cslInfo(("NV_NVDLA_sdp: functional fast mode enabled for direct convolution layers, up to %d host threads\n", NvdlaFunctionalFastModeThreadNum()));
+    }
 }
 
 void NV_NVDLA_sdp::SdpRdmaConsumerThread() {
@@ -899,6 +904,8 @@ void NV_NVDLA_sdp::SdpDataOperationDC() {
     // # Evaluated variable
 
     int16_t     *rdma_data_ptr;
+    std::vector<SdpLayerAtom> layer_atoms;
+    SdpLayerAtom layer_atom;
  
     switch (sdp_proc_precision_) {
         case NVDLA_SDP_D_DATA_FORMAT_0_PROC_PRECISION_INT8:
@@ -999,57 +1006,110 @@ void NV_NVDLA_sdp::SdpDataOperationDC() {
                     }
                     cslDebug((70, "\n" ));
 
+                    if (functional_fast_mode_) {
+                        // Keep the operands, SdpDataOperationLayerNative runs the whole layer
+                        memcpy(layer_atom.data_in,   hls_data_in_,                 sizeof(layer_atom.data_in));
+                        memcpy(layer_atom.x1_alu_op, hls_x1_alu_op_[0][proc_iter], sizeof(layer_atom.x1_alu_op));
+                        memcpy(layer_atom.x1_mul_op, hls_x1_mul_op_[0][proc_iter], sizeof(layer_atom.x1_mul_op));
+                        memcpy(layer_atom.x2_alu_op, hls_x2_alu_op_[0][proc_iter], sizeof(layer_atom.x2_alu_op));
+                        memcpy(layer_atom.x2_mul_op, hls_x2_mul_op_[0][proc_iter], sizeof(layer_atom.x2_mul_op));
+                        memcpy(layer_atom.y_alu_op,  hls_y_alu_op_ [0][proc_iter], sizeof(layer_atom.y_alu_op));
+                        memcpy(layer_atom.y_mul_op,  hls_y_mul_op_ [0][proc_iter], sizeof(layer_atom.y_mul_op));
+                        layer_atoms.push_back(layer_atom);
+                        continue;
+                    }
+
                     // Call HLS code
                     sdp_hls_wrapper_.sdp(hls_data_in_,
                             hls_x1_alu_op_[0][proc_iter], hls_x1_mul_op_[0][proc_iter],
                             hls_x2_alu_op_[0][proc_iter], hls_x2_mul_op_[0][proc_iter],
                             hls_y_alu_op_ [0][proc_iter], hls_y_mul_op_ [0][proc_iter]);
-                    if (sdp_ew_alu_algo_ == NVDLA_SDP_D_DP_EW_CFG_0_EW_ALU_ALGO_EQL &&
-                            sdp_ew_bypass_ == NVDLA_SDP_D_DP_EW_CFG_0_EW_BYPASS_NO &&
-                            sdp_ew_alu_bypass_ == NVDLA_SDP_D_DP_EW_CFG_0_EW_ALU_BYPASS_NO) {
-                        for(int i = 0; i < SDP_PARALLEL_PROC_NUM; i++) {
-                            if (sdp_hls_wrapper_.sdp_data_out[i] != 0) {
-                                sdp_reg_model::SdpUpdateStatusRegister((uint32_t)NVDLA_SDP_D_STATUS_0,
-                                        sdp_consumer_,
-                                        (uint32_t)1);
-                            }
-                        }
-                    } else {
-                        if (NVDLA_SDP_D_FEATURE_MODE_CFG_0_OUTPUT_DST_MEM == sdp_output_dst_) {
-                            int16_t *temp_ptr = new int16_t[16];
-                            cslAssert((temp_ptr != NULL));
-                            memcpy(temp_ptr, sdp_hls_wrapper_.sdp_data_out, ATOM_CUBE_SIZE);
-                            // Output destination is memory
-                            cslDebug((70, "NV_NVDLA_sdp::%s, DP->WDMA\n", __FUNCTION__));
-                            for(int i=0;i<SDP_PARALLEL_PROC_NUM;i++) {
-                                cslDebug((70, "0x%x ", (unsigned int)sdp_hls_wrapper_.sdp_data_out[i]));
-                            }
-                            cslDebug((70, "\n" ));
-                            wdma_fifo_->write(temp_ptr);    //32B
-
-#pragma CTC SKIP
-                            cslDebug((50, " write wdma_fifo_, height[%d], width[%d], proc[%d], total_num:%d\n",
-                                        height_iter, width_iter, proc_iter,
-                                        height_iter*width + width_iter*proc_num_per_atom + proc_iter+1));
-#pragma CTC ENDSKIP
-                        } else {
-                            // Output destination is PDP
-                            nvdla_sdp2pdp_t* payload = new nvdla_sdp2pdp_t;
-                            cslDebug((70, "%s, DP->PDP\n", __FUNCTION__));
-                            for(int i=0;i<SDP_PARALLEL_PROC_NUM;i++) {
-                                cslDebug((70, "0x%x ", (unsigned int)sdp_hls_wrapper_.sdp_data_out[i]));
-                            }
-                            cslDebug((70, "\n" ));
-                            memcpy((void *)payload->pd.sdp2pdp.data, sdp_hls_wrapper_.sdp_data_out, ATOM_CUBE_SIZE);
-                            sdp2pdp_b_transport(payload, b_transport_delay_);
-                            delete payload;
-                            cslDebug((70, "%s: send payload to PDP done\n", __FUNCTION__));
-                        }
-                    }
+                    SdpDataOperationOutput(sdp_hls_wrapper_.sdp_data_out);
                 }
             }
         }
     }
+    if (functional_fast_mode_) {
+        SdpDataOperationLayerNative(layer_atoms);
+    }
+}
+
+// Functional fast mode: runs sdp_hls_wrapper::sdp() for every atom of the layer
+// on layer_executor_, then sends the results out in the original order. Each
+// thread works on its own copy of sdp_hls_wrapper_, and their NaN/Inf, LUT and
+// saturation counters are summed into sdp_hls_wrapper_ afterwards.
+void NV_NVDLA_sdp::SdpDataOperationLayerNative(std::vector<SdpLayerAtom> &layer_atoms) {
+    uint64_t    atom_num = layer_atoms.size();
+    uint64_t    atom_iter;
+    uint32_t    worker_iter;
+
+    // HLS debug messages go through the SystemC report handler, which only the SystemC thread may use
+    layer_executor_.set_thread_num(cslLogEnabled(SC_DEBUG) ? 1 : NvdlaFunctionalFastModeThreadNum());
+    std::vector<sdp_hls_wrapper> workers(layer_executor_.worker_num(atom_num), sdp_hls_wrapper_);
+    for (worker_iter = 0; worker_iter < workers.size(); worker_iter++) {
+        workers[worker_iter].reset_stats_regs();
+    }
+    cslDebug((30, "NV_NVDLA_sdp::SdpDataOperationLayerNative, %ld atoms on %d threads\n", atom_num, (uint32_t)workers.size()));
+
+    layer_executor_.run(atom_num, [&](uint32_t worker, uint64_t atom_begin, uint64_t atom_end) {
+        uint64_t i;
+        for (i = atom_begin; i < atom_end; i++) {
+            SdpLayerAtom &atom = layer_atoms[i];
+            workers[worker].sdp(atom.data_in,
+                    atom.x1_alu_op, atom.x1_mul_op,
+                    atom.x2_alu_op, atom.x2_mul_op,
+                    atom.y_alu_op,  atom.y_mul_op);
+            memcpy(atom.data_out, workers[worker].sdp_data_out, sizeof(atom.data_out));
+        }
+    });
+    for (worker_iter = 0; worker_iter < workers.size(); worker_iter++) {
+        sdp_hls_wrapper_.merge_stats_regs(workers[worker_iter]);
+    }
+
+    for (atom_iter = 0; atom_iter < atom_num; atom_iter++) {
+        SdpDataOperationOutput(layer_atoms[atom_iter].data_out);
+    }
+}
+
+// Sends one atom of HLS output to WDMA or PDP, or checks it for the EQL mode status
+void NV_NVDLA_sdp::SdpDataOperationOutput(int16_t *sdp_data_out) {
+    if (sdp_ew_alu_algo_ == NVDLA_SDP_D_DP_EW_CFG_0_EW_ALU_ALGO_EQL &&
+            sdp_ew_bypass_ == NVDLA_SDP_D_DP_EW_CFG_0_EW_BYPASS_NO &&
+            sdp_ew_alu_bypass_ == NVDLA_SDP_D_DP_EW_CFG_0_EW_ALU_BYPASS_NO) {
+        for(int i = 0; i < SDP_PARALLEL_PROC_NUM; i++) {
+            if (sdp_data_out[i] != 0) {
+                sdp_reg_model::SdpUpdateStatusRegister((uint32_t)NVDLA_SDP_D_STATUS_0,
+                        sdp_consumer_,
+                        (uint32_t)1);
+            }
+        }
+    } else {
+        if (NVDLA_SDP_D_FEATURE_MODE_CFG_0_OUTPUT_DST_MEM == sdp_output_dst_) {
+            int16_t *temp_ptr = new int16_t[16];
+            cslAssert((temp_ptr != NULL));
+            memcpy(temp_ptr, sdp_data_out, ATOM_CUBE_SIZE);
+            // Output destination is memory
+            cslDebug((70, "NV_NVDLA_sdp::%s, DP->WDMA\n", __FUNCTION__));
+            for(int i=0;i<SDP_PARALLEL_PROC_NUM;i++) {
+                cslDebug((70, "0x%x ", (unsigned int)sdp_data_out[i]));
+            }
+            cslDebug((70, "\n" ));
+            wdma_fifo_->write(temp_ptr);    //32B
+            cslDebug((50, " write wdma_fifo_\n"));
+        } else {
+            // Output destination is PDP
+            nvdla_sdp2pdp_t* payload = new nvdla_sdp2pdp_t;
+            cslDebug((70, "%s, DP->PDP\n", __FUNCTION__));
+            for(int i=0;i<SDP_PARALLEL_PROC_NUM;i++) {
+                cslDebug((70, "0x%x ", (unsigned int)sdp_data_out[i]));
+            }
+            cslDebug((70, "\n" ));
+            memcpy((void *)payload->pd.sdp2pdp.data, sdp_data_out, ATOM_CUBE_SIZE);
+            sdp2pdp_b_transport(payload, b_transport_delay_);
+            delete payload;
+            cslDebug((70, "%s: send payload to PDP done\n", __FUNCTION__));
+        }
+    }
 }
 
 void NV_NVDLA_sdp::SdpDataOperationBatch() {
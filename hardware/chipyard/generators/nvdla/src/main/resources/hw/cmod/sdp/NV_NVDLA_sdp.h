@@ -27,6 +27,8 @@
 #include "sdp_rdma_reg_model.h"
 
 #include "sdp_hls_wrapper.h"
+#include "NvdlaLayerExecutor.h"
+#include <vector>
 
 #define MEM_BUSWIDTH_IN_BIT 64
 #define ATOM_CUBE_SIZE   32
@@ -75,6 +77,19 @@ class SdpConfig {
         uint8_t   sdp_rdma_erdma_data_mode_;
 };
 
+// Operands of one sdp_hls_wrapper::sdp() call, kept for a whole layer in functional fast mode
+class SdpLayerAtom {
+    public:
+        int32_t   data_in[16];
+        int16_t   x1_alu_op[16];
+        int16_t   x1_mul_op[16];
+        int16_t   x2_alu_op[16];
+        int16_t   x2_mul_op[16];
+        int16_t   y_alu_op[16];
+        int16_t   y_mul_op[16];
+        int16_t   data_out[16];
+};
+
 class ack_info {
     public:
         int8_t  is_mc;
@@ -114,6 +129,10 @@ class NV_NVDLA_sdp:
         SdpConfig           sdp_cfg_;
         // HLS module
         sdp_hls_wrapper sdp_hls_wrapper_;
+        // Functional fast mode runs the HLS datapath of direct convolution
+        // layers on layer_executor_, with one sdp_hls_wrapper copy per thread
+        bool    functional_fast_mode_;
+        NvdlaLayerExecutor layer_executor_;
 
         // Payloads
         nvdla_dma_wr_req_t *dma_wr_req_cmd_payload_;
@@ -195,6 +214,8 @@ class NV_NVDLA_sdp:
         void SdpDataOperationWG();
         void SdpDataOperationBatch();
         void SdpDataOperationDC();
+        void SdpDataOperationLayerNative(std::vector<SdpLayerAtom> &layer_atoms);
+        void SdpDataOperationOutput(int16_t *sdp_data_out);
         void SdpDataOperationThread();
         // ## WDMA thread
         void WdmaSequenceDC();
@@ -8,6 +8,7 @@
 int dramsim = -1;
 unsigned long loadmem_addr = 0;
 std::string ini_dir = "dramsim2_ini";
+int issue_width = 1;
 std::string loadmem_file = "";
 
 extern "C" void *memory_init(
@@ -33,6 +34,8 @@ extern "C" void *memory_init(
                 dramsim = 1;
             if (arg.find("+dramsim_ini_dir=") == 0)
                 ini_dir = arg.substr(strlen("+dramsim_ini_dir="));
+            if (arg.find("+dramsim_issue_width=") == 0)
+                issue_width = stoi(arg.substr(strlen("+dramsim_issue_width=")));
             if (arg.find("+loadmem_addr=") == 0)
                 loadmem_addr = stol(arg.substr(strlen("+loadmem_addr=")), NULL, 16);
             if (arg.find("+loadmem=") == 0)
@@ -41,7 +44,7 @@ extern "C" void *memory_init(
     }
 
     if (dramsim)
-        mm = (mm_t *) (new mm_dramsim2_t(ini_dir, 1 << id_bits, clock_hz));
+        mm = (mm_t *) (new mm_dramsim2_t(ini_dir, 1 << id_bits, clock_hz, issue_width));
     else
         mm = (mm_t *) (new mm_magic_t);
 
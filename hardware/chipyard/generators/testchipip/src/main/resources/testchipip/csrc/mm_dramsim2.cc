@@ -4,7 +4,6 @@
 #include "mm.h"
 #include <iostream>
 #include <fstream>
-#include <list>
 #include <queue>
 #include <cstring>
 #include <cstdlib>
@@ -16,24 +15,38 @@ using namespace DRAMSim;
 
 void mm_dramsim2_t::read_complete(unsigned id, uint64_t address, uint64_t clock_cycle)
 {
-  assert(!rreq[address].empty());
-  auto req = rreq[address].front();
-  uint64_t start_addr = (req.addr / word_size) * word_size;
-  for (size_t i = 0; i < req.len; i++) {
-    auto dat = read(start_addr + i * word_size);
-    rresp.push(mm_rresp_t(req.id, dat, (i == req.len - 1)));
+  auto &reqs = rreq[address];
+  assert(!reqs.empty());
+  auto req = reqs.front();
+  uint64_t start_addr = ((req.addr / word_size) * word_size) % size;
+
+  std::vector<char> buf;
+  if (!rresp_free_bufs.empty()) {
+    buf = std::move(rresp_free_bufs.back());
+    rresp_free_bufs.pop_back();
   }
+  buf.resize(req.len * word_size);
+  if (start_addr + buf.size() <= size) {
+    memcpy(&buf[0], data + start_addr, buf.size());
+  } else {
+    for (size_t i = 0; i < req.len; i++)
+      memcpy(&buf[i * word_size], data + (start_addr + i * word_size) % size, word_size);
+  }
+  rresp.push(mm_dramsim2_rresp_t(req.id, req.len, std::move(buf)));
   read_id_busy[req.id] = false;
-  rreq[address].pop();
+  if (!rreq_by_id[req.id].empty())
+    ready_ids.push(ready_id_t(rreq_by_id[req.id].front().first, req.id));
+  reqs.pop();
 }
 
 void mm_dramsim2_t::write_complete(unsigned id, uint64_t address, uint64_t clock_cycle)
 {
-  assert(!wreq[address].empty());
-  auto b_id = wreq[address].front();
+  auto &reqs = wreq[address];
+  assert(!reqs.empty());
+  auto b_id = reqs.front();
   bresp.push(b_id);
   write_id_busy[b_id] = false;
-  wreq[address].pop();
+  reqs.pop();
 }
 
 void power_callback(double a, double b, double c, double d)
@@ -97,21 +110,21 @@ void mm_dramsim2_t::tick(
   bool r_fire = !reset && r_valid() && r_ready;
   bool b_fire = !reset && b_valid() && b_ready;
 
-  if (mem->willAcceptTransaction()) {
-    for (auto it = rreq_queue.begin(); it != rreq_queue.end(); it++) {
-      if (!read_id_busy[it->id]) {
-        read_id_busy[it->id] = true;
-        auto transaction = *it;
-        rreq[transaction.addr].push(transaction);
-        mem->addTransaction(false, transaction.addr);
-        rreq_queue.erase(it);
-        break;
-      }
-    }
+  for (int i = 0; i < issue_width && !ready_ids.empty() && mem->willAcceptTransaction(); i++) {
+    uint64_t id = ready_ids.top().second;
+    ready_ids.pop();
+    auto transaction = rreq_by_id[id].front().second;
+    rreq_by_id[id].pop();
+    read_id_busy[id] = true;
+    rreq[transaction.addr].push(transaction);
+    mem->addTransaction(false, transaction.addr);
   }
 
   if (ar_fire) {
-    rreq_queue.push_back(mm_req_t(ar_id, 1 << ar_size, ar_len + 1, ar_addr));
+    uint64_t arrival = rreq_arrivals++;
+    if (!read_id_busy[ar_id] && rreq_by_id[ar_id].empty())
+      ready_ids.push(ready_id_t(arrival, ar_id));
+    rreq_by_id[ar_id].push(std::make_pair(arrival, mm_req_t(ar_id, 1 << ar_size, ar_len + 1, ar_addr)));
   }
 
   if (aw_fire) {
@@ -138,8 +151,13 @@ void mm_dramsim2_t::tick(
   if (b_fire)
     bresp.pop();
 
-  if (r_fire)
-    rresp.pop();
+  if (r_fire) {
+    auto &resp = rresp.front();
+    if (++resp.beat == resp.len) {
+      rresp_free_bufs.push_back(std::move(resp.data));
+      rresp.pop();
+    }
+  }
 
   mem->update();
   cycle++;
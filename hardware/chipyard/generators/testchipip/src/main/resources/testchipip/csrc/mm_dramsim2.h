@@ -5,9 +5,9 @@
 
 #include "mm.h"
 #include <DRAMSim.h>
-#include <map>
+#include <unordered_map>
 #include <queue>
-#include <list>
+#include <vector>
 #include <stdint.h>
 
 struct mm_req_t {
@@ -33,23 +33,45 @@ struct mm_req_t {
   }
 };
 
+// A read burst whose data is ready. The whole burst is copied out of the
+// backing store in one go when Dramsim2 completes it, into a buffer that is
+// recycled once its last beat has been returned.
+struct mm_dramsim2_rresp_t {
+  uint64_t id;
+  uint64_t len;
+  uint64_t beat;
+  std::vector<char> data;
+
+  mm_dramsim2_rresp_t(uint64_t id, uint64_t len, std::vector<char> &&data)
+  {
+    this->id = id;
+    this->len = len;
+    this->beat = 0;
+    this->data = std::move(data);
+  }
+};
+
 class mm_dramsim2_t : public mm_t
 {
  public:
   mm_dramsim2_t(int axi4_ids) : 
       read_id_busy(axi4_ids, false),
-      write_id_busy(axi4_ids, false) {};
-  mm_dramsim2_t(std::string ini_dir, int axi4_ids, uint64_t clock_hz = 0) :
+      write_id_busy(axi4_ids, false),
+      rreq_by_id(axi4_ids) {};
+  mm_dramsim2_t(std::string ini_dir, int axi4_ids, uint64_t clock_hz = 0, int issue_width = 1) :
       ini_dir(ini_dir),
       read_id_busy(axi4_ids, false),
       write_id_busy(axi4_ids, false),
-      clock_hz(clock_hz) {};
+      rreq_by_id(axi4_ids),
+      clock_hz(clock_hz),
+      issue_width(issue_width) {};
   mm_dramsim2_t(std::string memory_ini, std::string system_ini, std::string ini_dir, int axi4_ids) :
       memory_ini(memory_ini),
       system_ini(system_ini),
       ini_dir(ini_dir),
       read_id_busy(axi4_ids, false),
-      write_id_busy(axi4_ids, false) {};
+      write_id_busy(axi4_ids, false),
+      rreq_by_id(axi4_ids) {};
 
   virtual void init(size_t sz, int word_size, int line_size);
 
@@ -62,8 +84,8 @@ class mm_dramsim2_t : public mm_t
   virtual bool r_valid() { return !rresp.empty(); }
   virtual uint64_t r_resp() { return 0; }
   virtual uint64_t r_id() { return r_valid() ? rresp.front().id: 0; }
-  virtual void *r_data() { return r_valid() ? &rresp.front().data[0] : &dummy_data[0]; }
-  virtual bool r_last() { return r_valid() ? rresp.front().last : false; }
+  virtual void *r_data() { return r_valid() ? &rresp.front().data[rresp.front().beat * word_size] : &dummy_data[0]; }
+  virtual bool r_last() { return r_valid() ? rresp.front().beat == rresp.front().len - 1 : false; }
 
   virtual void tick
   (
@@ -110,19 +132,26 @@ class mm_dramsim2_t : public mm_t
   // Keep a FIFO of IDs that made reads to an address since Dramsim2 doesn't
   // track it. Reads or writes to the same address from different IDs can
   // collide
-  std::map<uint64_t, std::queue<uint64_t>> wreq;
-  std::map<uint64_t, std::queue<mm_req_t>> rreq;
-  std::queue<mm_rresp_t> rresp;
-  //std::map<uint64_t, std::queue<mm_rresp_t> > rreq;
+  std::unordered_map<uint64_t, std::queue<uint64_t>> wreq;
+  std::unordered_map<uint64_t, std::queue<mm_req_t>> rreq;
+  std::queue<mm_dramsim2_rresp_t> rresp;
+  std::vector<std::vector<char>> rresp_free_bufs;
 
 
-  // Track inflight requests by putting indexes to their positions in the
-  // stimulus vector in queues for each AXI channel
+  // Track inflight requests. Requests that have not yet been handed to
+  // Dramsim2 wait in a FIFO per AXI ID; an ID whose oldest request can be
+  // issued sits in ready_ids, ordered by the arrival of that request, so the
+  // oldest issuable request is always at the top.
+  typedef std::pair<uint64_t, uint64_t> ready_id_t; // (arrival, id)
   std::vector<bool> read_id_busy;
   std::vector<bool> write_id_busy;
-  std::list<mm_req_t> rreq_queue;
+  std::vector<std::queue<std::pair<uint64_t, mm_req_t>>> rreq_by_id;
+  std::priority_queue<ready_id_t, std::vector<ready_id_t>, std::greater<ready_id_t>> ready_ids;
+  uint64_t rreq_arrivals = 0;
 
   uint64_t clock_hz = 0;
+  // Maximum number of queued reads handed to Dramsim2 in a single tick
+  int issue_width = 1;
 
   void read_complete(unsigned id, uint64_t address, uint64_t clock_cycle);
   void write_complete(unsigned id, uint64_t address, uint64_t clock_cycle);
@@ -49,9 +49,11 @@ class blockdev_t: public bridge_driver_t
         virtual bool terminate() { return false; }
         virtual int exit_code() { return 0; }
         virtual void finish() {};
+        virtual std::string tick_domain() { return "blockdev" + std::to_string(blkdevno); }
 
     private:
         BLOCKDEVBRIDGEMODULE_struct * mmio_addrs;
+        int blkdevno;
         bool a_req_valid;
         bool a_req_ready;
         bool a_data_valid;
@@ -29,6 +29,7 @@ class dromajo_t: public bridge_driver_t
         virtual bool terminate() { return dromajo_failed; };
         virtual int exit_code() { return (dromajo_failed) ? dromajo_exit_code : 0; };
         virtual void finish() { this->flush(); };
+        virtual std::string tick_domain() { return "dromajo"; };
 
     private:
         DROMAJOBRIDGEMODULE_struct * _mmio_addrs;
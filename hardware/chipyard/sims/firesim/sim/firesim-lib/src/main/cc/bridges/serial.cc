@@ -74,16 +74,36 @@ void serial_t::go() {
 }
 
 void serial_t::send() {
-    while(fesvr->data_available() && read(this->mmio_addrs->in_ready)) {
-        write(this->mmio_addrs->in_bits, fesvr->recv_word());
-        write(this->mmio_addrs->in_valid, 1);
+    // each word's writes share a batch with the in_ready check for the next
+    mmio_batch_t batch;
+    data_t in_ready = 0;
+    if (fesvr->data_available()) {
+        in_ready = read(this->mmio_addrs->in_ready);
+    }
+    while(fesvr->data_available() && in_ready) {
+        batch.write(this->mmio_addrs->in_bits, fesvr->recv_word());
+        batch.write(this->mmio_addrs->in_valid, 1);
+        if (fesvr->data_available()) {
+            batch.read(this->mmio_addrs->in_ready, &in_ready);
+        }
+        issue_mmio_batch(batch);
     }
 }
 
 void serial_t::recv() {
-    while(read(this->mmio_addrs->out_valid)) {
-        fesvr->send_word(read(this->mmio_addrs->out_bits));
-        write(this->mmio_addrs->out_ready, 1);
+    // out_bits has no read side effects, so it is fetched along with
+    // out_valid, and the dequeue of each word shares a batch with the next
+    mmio_batch_t batch;
+    data_t out_valid, out_bits;
+    batch.read(this->mmio_addrs->out_valid, &out_valid);
+    batch.read(this->mmio_addrs->out_bits, &out_bits);
+    issue_mmio_batch(batch);
+    while(out_valid) {
+        fesvr->send_word(out_bits);
+        batch.write(this->mmio_addrs->out_ready, 1);
+        batch.read(this->mmio_addrs->out_valid, &out_valid);
+        batch.read(this->mmio_addrs->out_bits, &out_bits);
+        issue_mmio_batch(batch);
     }
 }
 
@@ -12,6 +12,10 @@
 #include <unistd.h>
 
 #include <sys/mman.h>
+#include <limits.h>
+#include <time.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
 
 // DO NOT MODIFY PARAMS BELOW THIS LINE
 #define TOKENS_PER_BIGTOKEN 7
@@ -20,7 +24,9 @@
 
 #define BUFWIDTH (512/8)
 #define BUFBYTES (SIMLATENCY_BT*BUFWIDTH)
-#define EXTRABYTES 1
+// the cache line after each buffer holds the futex flag that hands it to
+// the other side. this layout must match target-design/switch/shmemport.h
+#define EXTRABYTES 64
 
 #define FLIT_BITS 64
 #define PACKET_MAX_FLITS 190
@@ -42,6 +48,41 @@ static void simplify_frac(int n, int d, int *nn, int *dd)
     *dd = d / a;
 }
 
+struct shmem_flag {
+    uint32_t ready;
+    uint32_t waiters;
+};
+
+static void shmem_flag_post(char * flagaddr) {
+    struct shmem_flag * flag = (struct shmem_flag *)flagaddr;
+    __atomic_store_n(&flag->ready, 1, __ATOMIC_RELEASE);
+    // pairs with the waiter's increment, so either we see it or it sees ready
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&flag->waiters, __ATOMIC_RELAXED)) {
+        syscall(SYS_futex, &flag->ready, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+}
+
+// returns true if the caller had to sleep
+static bool shmem_flag_wait(char * flagaddr, int spin_iters) {
+    struct shmem_flag * flag = (struct shmem_flag *)flagaddr;
+    for (int i = 0; i < spin_iters; i++) {
+        if (__atomic_load_n(&flag->ready, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+    }
+    __atomic_add_fetch(&flag->waiters, 1, __ATOMIC_SEQ_CST);
+    while (!__atomic_load_n(&flag->ready, __ATOMIC_ACQUIRE)) {
+        syscall(SYS_futex, &flag->ready, FUTEX_WAIT, 0, NULL, NULL, 0);
+    }
+    __atomic_sub_fetch(&flag->waiters, 1, __ATOMIC_SEQ_CST);
+    return true;
+}
+
+static void shmem_flag_clear(char * flagaddr) {
+    __atomic_store_n(&((struct shmem_flag *)flagaddr)->ready, 0, __ATOMIC_RELAXED);
+}
+
 #define niclog_printf(...) if (this->niclog) { fprintf(this->niclog, __VA_ARGS__); fflush(this->niclog); }
 
 simplenic_t::simplenic_t(simif_t *sim, std::vector<std::string> &args,
@@ -49,12 +90,14 @@ simplenic_t::simplenic_t(simif_t *sim, std::vector<std::string> &args,
         long dma_addr): bridge_driver_t(sim)
 {
     this->mmio_addrs = mmio_addrs;
+    this->simplenicno = simplenicno;
 
     const char *niclogfile = NULL;
     const char *shmemportname = NULL;
     int netbw = MAX_BANDWIDTH, netburst = 8;
 
     this->loopback = false;
+    this->shmem_spin_iters = 4096;
     this->niclog = NULL;
     this->mac_lendian = 0;
     this->LINKLATENCY = 0;
@@ -71,6 +114,7 @@ simplenic_t::simplenic_t(simif_t *sim, std::vector<std::string> &args,
     std::string netburst_arg = std::string("+netburst") + num_equals;
     std::string linklatency_arg = std::string("+linklatency") + num_equals;
     std::string shmemportname_arg = std::string("+shmemportname") + num_equals;
+    std::string shmemspin_arg = std::string("+shmemspin") + num_equals;
 
 
     for (auto &arg: args) {
@@ -115,6 +159,10 @@ simplenic_t::simplenic_t(simif_t *sim, std::vector<std::string> &args,
         if (arg.find(shmemportname_arg) == 0) {
             shmemportname = const_cast<char*>(arg.c_str()) + shmemportname_arg.length();
         }
+        if (arg.find(shmemspin_arg) == 0) {
+            char *str = const_cast<char*>(arg.c_str()) + shmemspin_arg.length();
+            this->shmem_spin_iters = atoi(str);
+        }
     }
 
     assert(this->LINKLATENCY > 0);
@@ -129,6 +177,7 @@ simplenic_t::simplenic_t(simif_t *sim, std::vector<std::string> &args,
     printf("using link latency: %d cycles\n", this->LINKLATENCY);
     printf("using netbw: %d\n", netbw);
     printf("using netburst: %d\n", netburst);
+    printf("using shmem spin: %d\n", this->shmem_spin_iters);
 
     if (niclogfile) {
         this->niclog = fopen(niclogfile, "w");
@@ -169,6 +218,11 @@ simplenic_t::simplenic_t(simif_t *sim, std::vector<std::string> &args,
 }
 
 simplenic_t::~simplenic_t() {
+    if (!loopback) {
+        uint64_t waits = spin_waits + sleep_waits;
+        printf("simplenic: %ld exchanges, %ld waited spinning, %ld waited sleeping, avg wait %ld ns\n",
+                iter, spin_waits, sleep_waits, waits ? wait_ns / waits : 0L);
+    }
     if (this->niclog)
         fclose(this->niclog);
     if (loopback) {
@@ -254,7 +308,7 @@ void simplenic_t::tick() {
         niclog_printf("send iter %ld\n", iter);
 #endif
 
-        pcis_read_bufs[currentround][BUFBYTES] = 1;
+        shmem_flag_post(pcis_read_bufs[currentround] + BUFBYTES);
 
 #ifdef TOKENVERIFY
         // the widget is designed to tag tokens with a 43 bit number,
@@ -297,8 +351,18 @@ void simplenic_t::tick() {
 #endif
 
         if (!loopback) {
-            volatile uint8_t * polladdr = (uint8_t*)(pcis_write_bufs[currentround] + BUFBYTES);
-            while (*polladdr == 0) { ; }
+            char * flagaddr = pcis_write_bufs[currentround] + BUFBYTES;
+            if (!__atomic_load_n(&((struct shmem_flag *)flagaddr)->ready, __ATOMIC_ACQUIRE)) {
+                struct timespec tstart, tend;
+                clock_gettime(CLOCK_MONOTONIC, &tstart);
+                if (shmem_flag_wait(flagaddr, this->shmem_spin_iters)) {
+                    sleep_waits++;
+                } else {
+                    spin_waits++;
+                }
+                clock_gettime(CLOCK_MONOTONIC, &tend);
+                wait_ns += (tend.tv_sec - tstart.tv_sec) * 1000000000L + (tend.tv_nsec - tstart.tv_nsec);
+            }
         }
 #ifdef DEBUG_NIC_PRINT
         niclog_printf("done recv iter %ld\n", iter);
@@ -326,7 +390,7 @@ void simplenic_t::tick() {
                 dma_addr,
                 pcis_write_bufs[currentround],
                 BUFWIDTH * tokens_this_round);
-        pcis_write_bufs[currentround][BUFBYTES] = 0;
+        shmem_flag_clear(pcis_write_bufs[currentround] + BUFBYTES);
         if (token_bytes_sent_to_fpga != tokens_this_round * BUFWIDTH) {
             printf("ERR MISMATCH! on writing tokens in. actually wrote in %d bytes, wanted %d bytes.\n", token_bytes_sent_to_fpga, BUFWIDTH * tokens_this_round);
             printf("errno: %s\n", strerror(errno));
@@ -23,9 +23,11 @@ class simplenic_t: public bridge_driver_t
         virtual bool terminate() { return false; };
         virtual int exit_code() { return 0; }
         virtual void finish() {};
+        virtual std::string tick_domain() { return "simplenic" + std::to_string(simplenicno); }
 
     private:
         simif_t* sim;
+        int simplenicno;
         uint64_t mac_lendian;
         char * pcis_read_bufs[2];
         char * pcis_write_bufs[2];
@@ -41,6 +43,13 @@ class simplenic_t: public bridge_driver_t
         SIMPLENICBRIDGEMODULE_struct *mmio_addrs;
         bool loopback;
 
+        // how many times to poll the shmem flag before sleeping on it
+        int shmem_spin_iters;
+        // wait statistics for the shmem exchange, reported on exit
+        uint64_t spin_waits = 0;
+        uint64_t sleep_waits = 0;
+        uint64_t wait_ns = 0;
+
         // checking for token loss
         uint32_t next_token_from_fpga = 0x0;
         uint32_t next_token_from_socket = 0x0;
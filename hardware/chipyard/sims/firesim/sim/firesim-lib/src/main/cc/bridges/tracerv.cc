@@ -16,6 +16,8 @@
 
 // The maximum number of beats available in the FPGA-side FIFO
 #define QUEUE_DEPTH 6144
+// The number of QUEUE_DEPTH-sized buffers that can be waiting on the writer
+#define NUM_TRACE_BUFS 4
 
 // put FIREPERF in a mode that writes a simple log for processing later.
 // useful for iterating on software side only without re-running on FPGA.
@@ -61,6 +63,8 @@ tracerv_t::tracerv_t(
     std::string testoutput_arg =         std::string("+trace-test-output");
     // Formats the output before dumping the trace to file
     std::string humanreadable_arg =    std::string("+trace-humanreadable");
+    // Compresses the trace file with gzip while it is being written
+    std::string compress_arg =         std::string("+trace-compress");
 
     std::string trace_output_format_arg = std::string("+trace-output-format") + suffix;
     std::string dwarf_file_arg =           std::string("+dwarf-file-name") + suffix;
@@ -98,6 +102,9 @@ tracerv_t::tracerv_t(
         if (arg.find(testoutput_arg) == 0) {
             this->test_output = true;
         }
+        if (arg.find(compress_arg) == 0) {
+            this->compress = true;
+        }
         if (arg.find(trace_output_format_arg) == 0) {
             char *str = const_cast<char*>(arg.c_str()) + trace_output_format_arg.length();
             outputfmtselect = atol(str);
@@ -111,7 +118,12 @@ tracerv_t::tracerv_t(
     if (tracefilename) {
         // giving no tracefilename means we will create NO tracefiles
         std::string tfname = std::string(tracefilename) + std::string("-C") + std::to_string(tracerno);
-        this->tracefile = fopen(tfname.c_str(), "w");
+        if (this->compress) {
+            std::string gzip_cmd = "gzip -c > '" + tfname + ".gz'";
+            this->tracefile = popen(gzip_cmd.c_str(), "w");
+        } else {
+            this->tracefile = fopen(tfname.c_str(), "w");
+        }
         if (!this->tracefile) {
             fprintf(stderr, "Could not open Trace log file: %s\n", tracefilename);
             abort();
@@ -147,8 +159,28 @@ tracerv_t::tracerv_t(
 }
 
 tracerv_t::~tracerv_t() {
+    if (this->writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(this->batch_lock);
+            this->writer_done = true;
+        }
+        this->batch_cond.notify_all();
+        this->writer.join();
+
+        double secs = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - this->trace_start_time).count();
+        fprintf(stderr, "TracerV: %lu bytes traced in %.2f s (%.2f MB/s)\n",
+                this->bytes_traced, secs, secs > 0 ? this->bytes_traced / secs / 1e6 : 0.0);
+    }
+    for (auto buf: this->free_bufs) {
+        free(buf);
+    }
     if (this->tracefile) {
-        fclose(this->tracefile);
+        if (this->compress) {
+            pclose(this->tracefile);
+        } else {
+            fclose(this->tracefile);
+        }
     }
     free(this->mmio_addrs);
 }
@@ -197,12 +229,61 @@ void tracerv_t::init() {
       printf("TracerV: No trigger selected. Trigger enabled from %lu to %lu cycles\n", 0, ULONG_MAX);
     }
     write(this->mmio_addrs->initDone, true);
+
+    if (this->trace_enabled) {
+        for (int i = 0; i < NUM_TRACE_BUFS; i++) {
+            void * buf = aligned_alloc(4096, QUEUE_DEPTH * 64);
+            assert(buf);
+            this->free_bufs.push_back((uint64_t *)buf);
+        }
+        this->trace_start_time = std::chrono::steady_clock::now();
+        this->writer = std::thread(&tracerv_t::writer_loop, this);
+    }
 }
 
 void tracerv_t::process_tokens(int num_beats) {
-    // TODO. as opt can mmap file and just load directly into it.
-    alignas(4096) uint64_t OUTBUF[QUEUE_DEPTH * 8];
-    pull(dma_addr, (char*)OUTBUF, num_beats * 64);
+    uint64_t * buf;
+    {
+        std::unique_lock<std::mutex> lock(this->batch_lock);
+        this->batch_cond.wait(lock, [this] { return !this->free_bufs.empty(); });
+        buf = this->free_bufs.back();
+        this->free_bufs.pop_back();
+    }
+
+    pull(dma_addr, (char*)buf, num_beats * 64);
+    this->bytes_traced += num_beats * 64;
+
+    {
+        std::lock_guard<std::mutex> lock(this->batch_lock);
+        this->full_batches.push_back({buf, num_beats});
+    }
+    this->batch_cond.notify_all();
+}
+
+void tracerv_t::writer_loop() {
+    while (true) {
+        trace_batch_t batch;
+        {
+            std::unique_lock<std::mutex> lock(this->batch_lock);
+            this->batch_cond.wait(lock, [this] { return this->writer_done || !this->full_batches.empty(); });
+            if (this->full_batches.empty()) {
+                return;
+            }
+            batch = this->full_batches.front();
+            this->full_batches.pop_front();
+        }
+
+        write_tokens(batch.buf, batch.num_beats);
+
+        {
+            std::lock_guard<std::mutex> lock(this->batch_lock);
+            this->free_bufs.push_back(batch.buf);
+        }
+        this->batch_cond.notify_all();
+    }
+}
+
+void tracerv_t::write_tokens(uint64_t * OUTBUF, int num_beats) {
     //check that a tracefile exists (one is enough) since the manager
     //does not create a tracefile when trace_enable is disabled, but the
     //TracerV bridge still exists, and no tracefile is created by default.
@@ -231,7 +312,7 @@ void tracerv_t::process_tokens(int num_beats) {
             }
         } else if (this->fireperf) {
 
-            for (int i = 0; i < QUEUE_DEPTH * 8; i+=8) {
+            for (int i = 0; i < num_beats * 8; i+=8) {
                 uint64_t cycle_internal = OUTBUF[i+0];
 
                 for (int q = 0; q < max_core_ipc; q++) {
@@ -246,14 +327,10 @@ void tracerv_t::process_tokens(int num_beats) {
                 }
             }
         } else {
-            for (int i = 0; i < QUEUE_DEPTH * 8; i+=8) {
-                // this stores as raw binary. stored as little endian.
-                // e.g. to get the same thing as the human readable above,
-                // flip all the bytes in each 512-bit line.
-                for (int q = 0; q < 8; q++) {
-                    fwrite(OUTBUF + (i+q), sizeof(uint64_t), 1, this->tracefile);
-                }
-            }
+            // this stores as raw binary. stored as little endian.
+            // e.g. to get the same thing as the human readable above,
+            // flip all the bytes in each 512-bit line.
+            fwrite(OUTBUF, 64, num_beats, this->tracefile);
         }
     }
 }
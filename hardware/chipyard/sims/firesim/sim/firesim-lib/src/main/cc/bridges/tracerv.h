@@ -5,6 +5,11 @@
 #include "bridges/bridge_driver.h"
 #include "bridges/clock_info.h"
 #include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include "bridges/tracerv/tracerv_processing.h"
 #include "bridges/tracerv/trace_tracker.h"
 
@@ -75,8 +80,29 @@ class tracerv_t: public bridge_driver_t
         std::string tracefilename;
         std::string dwarf_file_name;
         bool fireperf = false;
+        // Pipe the trace file through gzip as it is written
+        bool compress = false;
+
+        // DMA pulls land in one of a small pool of buffers, which a writer
+        // thread then formats and writes out, so file I/O never stalls the
+        // simulation thread unless every buffer is in flight.
+        struct trace_batch_t {
+            uint64_t * buf;
+            int num_beats;
+        };
+        std::vector<uint64_t *> free_bufs;
+        std::deque<trace_batch_t> full_batches;
+        std::mutex batch_lock;
+        std::condition_variable batch_cond;
+        std::thread writer;
+        bool writer_done = false;
+
+        uint64_t bytes_traced = 0;
+        std::chrono::steady_clock::time_point trace_start_time;
 
         void process_tokens(int num_beats);
+        void write_tokens(uint64_t * buf, int num_beats);
+        void writer_loop();
         int beats_available_stable();
         void flush();
 };
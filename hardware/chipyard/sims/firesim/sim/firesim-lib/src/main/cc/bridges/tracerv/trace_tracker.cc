@@ -7,6 +7,20 @@ TraceTracker::TraceTracker(std::string binary_with_dwarf, FILE * tracefile)
 {
     this->bin_dump = new ObjdumpedBinary(binary_with_dwarf);
     this->tracefile = tracefile;
+    this->last_instr = nullptr;
+}
+
+void TraceTracker::pushLabel(uint32_t label, uint64_t cycle, bool asm_sequence)
+{
+    label_stack.emplace_back(label, cycle, label_stack.size() + 1, asm_sequence);
+    label_stack.back().pre_print(this->tracefile, this->bin_dump->getLabel(label));
+}
+
+void TraceTracker::popLabel()
+{
+    LabelMeta& pop_label = label_stack.back();
+    pop_label.post_print(this->tracefile, this->bin_dump->getLabel(pop_label.label));
+    label_stack.pop_back();
 }
 
 void TraceTracker::addInstruction(uint64_t inst_addr, uint64_t cycle)
@@ -23,93 +37,57 @@ void TraceTracker::addInstruction(uint64_t inst_addr, uint64_t cycle)
 #endif
 
     if (!this_instr) {
-        if ((label_stack.size() == 1) && (std::string("USERSPACE_ALL").compare(label_stack[label_stack.size()-1]->label) == 0)) {
-            LabelMeta * last_label = label_stack[label_stack.size()-1];
-            last_label->end_cycle = cycle;
+        if ((label_stack.size() == 1) && (label_stack.back().label == USERSPACE_ALL_LABEL)) {
+            label_stack.back().end_cycle = cycle;
         } else {
             while (label_stack.size() > 0) {
-                LabelMeta * pop_label = label_stack[label_stack.size()-1];
-                label_stack.pop_back();
-                pop_label->post_print(this->tracefile);
-                delete pop_label;
+                popLabel();
                 if (label_stack.size() > 0) {
-                    LabelMeta * last_label = label_stack[label_stack.size()-1];
-                    last_label->end_cycle = cycle;
+                    label_stack.back().end_cycle = cycle;
                 }
             }
-            LabelMeta * new_label = new LabelMeta();
-            new_label->label = std::string("USERSPACE_ALL");
-            new_label->start_cycle = cycle;
-            new_label->end_cycle = cycle;
-            new_label->indent = label_stack.size() + 1;
-            new_label->asm_sequence = false;
-            label_stack.push_back(new_label);
-            new_label->pre_print(this->tracefile);
+            pushLabel(USERSPACE_ALL_LABEL, cycle, false);
         }
     } else {
-        std::string label = this_instr->function_name;
+        uint32_t label = this_instr->label_id;
 
-        if ((label_stack.size() > 0) && (std::string("USERSPACE_ALL").compare(label_stack[label_stack.size()-1]->label) == 0)) {
-            LabelMeta * pop_label = label_stack[label_stack.size()-1];
-            label_stack.pop_back();
-            pop_label->post_print(this->tracefile);
-            delete pop_label;
+        if ((label_stack.size() > 0) && (label_stack.back().label == USERSPACE_ALL_LABEL)) {
+            popLabel();
         }
 
-        if ((label_stack.size() > 0) && (label.compare(label_stack[label_stack.size()-1]->label) == 0)) {
-            LabelMeta * last_label = label_stack[label_stack.size()-1];
-            last_label->end_cycle = cycle;
+        if ((label_stack.size() > 0) && (label_stack.back().label == label)) {
+            label_stack.back().end_cycle = cycle;
         } else {
             if ((label_stack.size() > 0) and
                 this_instr->in_asm_sequence and
-                label_stack[label_stack.size()-1]->asm_sequence) {
+                label_stack.back().asm_sequence) {
 
-                LabelMeta * pop_label = label_stack[label_stack.size()-1];
-                label_stack.pop_back();
-                pop_label->post_print(this->tracefile);
-                delete pop_label;
-
-                LabelMeta * new_label = new LabelMeta();
-                new_label->label = label;
-                new_label->start_cycle = cycle;
-                new_label->end_cycle = cycle;
-                new_label->indent = label_stack.size() + 1;
-                new_label->asm_sequence = this_instr->in_asm_sequence;
-                label_stack.push_back(new_label);
-                new_label->pre_print(this->tracefile);
+                popLabel();
+                pushLabel(label, cycle, this_instr->in_asm_sequence);
             } else if ((label_stack.size() > 0) and
                     (this_instr->is_callsite or !(this_instr->is_fn_entry))) {
                 uint64_t unwind_start_level = (uint64_t)(-1);
                 while ((label_stack.size() > 0) and
-                        (label_stack[label_stack.size()-1]->label.compare(label) != 0)) {
-                    LabelMeta * pop_label = label_stack[label_stack.size()-1];
-                    label_stack.pop_back();
-                    pop_label->post_print(this->tracefile);
+                        (label_stack.back().label != label)) {
                     if (unwind_start_level == (uint64_t)(-1)) {
-                        unwind_start_level = pop_label->indent;
+                        unwind_start_level = label_stack.back().indent;
                     }
-                    delete pop_label;
+                    popLabel();
                     if (label_stack.size() > 0) {
-                        LabelMeta * last_label = label_stack[label_stack.size()-1];
-                        last_label->end_cycle = cycle;
+                        label_stack.back().end_cycle = cycle;
                     }
                 }
                 if (label_stack.size() == 0) {
-                    fprintf(this->tracefile, "WARN: STACK ZEROED WHEN WE WERE LOOKING FOR LABEL: %s, iaddr 0x%" PRIx64 "\n", label.c_str(), inst_addr);
+                    fprintf(this->tracefile, "WARN: STACK ZEROED WHEN WE WERE LOOKING FOR LABEL: %s, iaddr 0x%" PRIx64 "\n", this_instr->function_name.c_str(), inst_addr);
                     fprintf(this->tracefile, "WARN: is_callsite was: %d, is_fn_entry was: %d\n", this_instr->is_callsite, this_instr->is_fn_entry);
                     fprintf(this->tracefile, "WARN: Unwind started at level: dec %" PRIu64 "\n", unwind_start_level);
                     fprintf(this->tracefile, "WARN: Last instr was\n");
-                    this->last_instr->printMeFile(this->tracefile, std::string("WARN: "));
+                    if (this->last_instr) {
+                        this->last_instr->printMeFile(this->tracefile, std::string("WARN: "));
+                    }
                 }
             } else {
-                LabelMeta * new_label = new LabelMeta();
-                new_label->label = label;
-                new_label->start_cycle = cycle;
-                new_label->end_cycle = cycle;
-                new_label->indent = label_stack.size() + 1;
-                new_label->asm_sequence = this_instr->in_asm_sequence;
-                label_stack.push_back(new_label);
-                new_label->pre_print(this->tracefile);
+                pushLabel(label, cycle, this_instr->in_asm_sequence);
             }
         }
         this->last_instr = this_instr;
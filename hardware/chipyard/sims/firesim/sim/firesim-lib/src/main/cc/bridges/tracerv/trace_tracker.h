@@ -7,29 +7,31 @@
 class LabelMeta
 {
     public:
-        std::string label;
+        uint32_t label;
         uint64_t start_cycle;
         uint64_t end_cycle;
         uint64_t indent;
         bool asm_sequence;
 
-        LabelMeta() { this->asm_sequence = false; }
+        LabelMeta(uint32_t label, uint64_t cycle, uint64_t indent, bool asm_sequence) :
+            label(label), start_cycle(cycle), end_cycle(cycle),
+            indent(indent), asm_sequence(asm_sequence) {}
 
-        void pre_print(FILE * tracefile) {
+        void pre_print(FILE * tracefile, const std::string& name) {
 #ifdef INDENT_SPACES
             std::string ind(indent, ' ');
-            fprintf(tracefile, "%sStart label: %s at %" PRIu64 " cycles.\n", ind.c_str(), label.c_str(), start_cycle);
+            fprintf(tracefile, "%sStart label: %s at %" PRIu64 " cycles.\n", ind.c_str(), name.c_str(), start_cycle);
 #else
-            fprintf(tracefile, "Indent: %" PRIu64 ", Start label: %s, At cycle: %" PRIu64 "\n", indent, label.c_str(), start_cycle);
+            fprintf(tracefile, "Indent: %" PRIu64 ", Start label: %s, At cycle: %" PRIu64 "\n", indent, name.c_str(), start_cycle);
 #endif
         }
 
-        void post_print(FILE * tracefile) {
+        void post_print(FILE * tracefile, const std::string& name) {
 #ifdef INDENT_SPACES
             std::string ind(indent, ' ');
-            fprintf(tracefile, "%sEnd label: %s at %" PRIu64 " cycles.\n", ind.c_str(), label.c_str(), end_cycle);
+            fprintf(tracefile, "%sEnd label: %s at %" PRIu64 " cycles.\n", ind.c_str(), name.c_str(), end_cycle);
 #else
-            fprintf(tracefile, "Indent: %" PRIu64 ", End label: %s, End cycle: %" PRIu64 "\n", indent, label.c_str(), end_cycle);
+            fprintf(tracefile, "Indent: %" PRIu64 ", End label: %s, End cycle: %" PRIu64 "\n", indent, name.c_str(), end_cycle);
 #endif
         }
 };
@@ -39,10 +41,13 @@ class TraceTracker
 {
     private:
         ObjdumpedBinary * bin_dump;
-        std::vector<LabelMeta *> label_stack;
+        std::vector<LabelMeta> label_stack;
         FILE * tracefile;
         Instr * last_instr;
 
+        void pushLabel(uint32_t label, uint64_t cycle, bool asm_sequence);
+        void popLabel();
+
     public:
         TraceTracker(std::string binary_with_dwarf, FILE * tracefile);
         void addInstruction(uint64_t inst_addr, uint64_t cycle);
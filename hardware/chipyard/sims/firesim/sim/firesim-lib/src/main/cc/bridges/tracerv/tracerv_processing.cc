@@ -7,8 +7,23 @@
 #include <unistd.h>
 #include <fcntl.h>
 
+uint32_t ObjdumpedBinary::internLabel(const std::string &label)
+{
+    auto it = this->label_ids.find(label);
+    if (it != this->label_ids.end()) {
+        return it->second;
+    }
+    uint32_t label_id = this->labels.size();
+    this->labels.push_back(label);
+    this->label_ids[label] = label_id;
+    return label_id;
+}
+
 ObjdumpedBinary::ObjdumpedBinary(std::string binaryWithDwarf)
 {
+    this->baseaddr = 0;
+    this->internLabel("USERSPACE_ALL");
+
     // annotate with dwarf information
     // fn names and callsites
     int fd = open(binaryWithDwarf.c_str(), O_RDONLY);
@@ -32,7 +47,7 @@ ObjdumpedBinary::ObjdumpedBinary(std::string binaryWithDwarf)
         this->baseaddr = base;
     }
     if (limit > this->baseaddr) {
-        this->progtext.resize(limit - this->baseaddr);
+        this->progtext.resize((limit - this->baseaddr + 1) >> INSTR_ALIGN_SHIFT);
     }
 
     size_t offset = 0;
@@ -43,8 +58,8 @@ ObjdumpedBinary::ObjdumpedBinary(std::string binaryWithDwarf)
 
         sub.print(pc_low);
 
-        size_t start = pc_low - this->baseaddr;
-        size_t end = (sub.pc_end > pc_low) ? (sub.pc_end - this->baseaddr) : start;
+        size_t start = (pc_low - this->baseaddr) >> INSTR_ALIGN_SHIFT;
+        size_t end = (sub.pc_end > pc_low) ? ((sub.pc_end - this->baseaddr + 1) >> INSTR_ALIGN_SHIFT) : start;
         if (this->progtext.size() < end) {
             this->progtext.resize(end);
         }
@@ -71,6 +86,7 @@ ObjdumpedBinary::ObjdumpedBinary(std::string binaryWithDwarf)
         Instr* entry = new Instr();
         entry->addr = pc_low; // FIXME: unused
         entry->function_name = sub.name;
+        entry->label_id = this->internLabel(sub.name);
         entry->is_fn_entry = true;
         entry->in_asm_sequence = !sub.function;
         this->progtext[start] = entry;
@@ -82,7 +98,7 @@ ObjdumpedBinary::ObjdumpedBinary(std::string binaryWithDwarf)
                 fprintf(stderr, "callsite out of range: %" PRIx64 " <%s>\n", site.pc, sub.name.c_str());
                 continue;
             }
-            offset = site.pc - this->baseaddr;
+            offset = (site.pc - this->baseaddr) >> INSTR_ALIGN_SHIFT;
             if (sub.pc_end != 0) {
                 if (offset >= end) {
                     fprintf(stderr, "callsite out of range: %" PRIx64 " <%s>\n", site.pc, sub.name.c_str());
@@ -93,7 +109,7 @@ ObjdumpedBinary::ObjdumpedBinary(std::string binaryWithDwarf)
             }
 
             if (this->progtext[offset] != nullptr) {
-                uint64_t pc = this->baseaddr + offset;
+                uint64_t pc = this->baseaddr + (offset << INSTR_ALIGN_SHIFT);
                 fprintf(stderr, "callsite overlap: %" PRIx64 " <%s>\n", pc, sub.name.c_str());
                 continue;
             }
@@ -117,7 +133,7 @@ ObjdumpedBinary::ObjdumpedBinary(std::string binaryWithDwarf)
                 }
                 this->progtext[offset] = body;
             } else if (insn != target) {
-                uint64_t pc = this->baseaddr + offset;
+                uint64_t pc = this->baseaddr + (offset << INSTR_ALIGN_SHIFT);
                 fprintf(stderr, "subroutine overlap: %" PRIx64 " <%s>\n", pc, sub.name.c_str());
             }
         }
@@ -140,15 +156,3 @@ ObjdumpedBinary::ObjdumpedBinary(std::string binaryWithDwarf)
         }
     }
 }
-
-
-Instr * ObjdumpedBinary::getInstrFromAddr(uint64_t lookupaddress) {
-    if (lookupaddress < this->baseaddr) {
-        return NULL;
-    }
-    uint64_t computeaddr = lookupaddress - this->baseaddr;
-    if (computeaddr >= this->progtext.size()) {
-        return NULL;
-    }
-    return this->progtext[computeaddr];
-}
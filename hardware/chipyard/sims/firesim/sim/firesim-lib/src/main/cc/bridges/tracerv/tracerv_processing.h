@@ -6,6 +6,7 @@
 #include <inttypes.h>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 #include <iostream>
 #include <fstream>
@@ -19,12 +20,15 @@ class Instr
     uint64_t addr;
     std::string label;
     std::string function_name;
+    // function_name interned by ObjdumpedBinary, so labels compare as integers
+    uint32_t label_id;
     bool is_fn_entry;
     bool is_callsite;
     bool in_asm_sequence;
 
     Instr()
     {
+        label_id = 0;
         is_callsite = false;
         is_fn_entry = false;
         in_asm_sequence = false;
@@ -40,14 +44,35 @@ class Instr
 };
 
 
+// Label ID reserved for addresses outside the binary
+#define USERSPACE_ALL_LABEL 0
+
 class ObjdumpedBinary
 {
+    // RISC-V instructions are at least 2-byte aligned, so progtext holds one
+    // entry per halfword rather than per byte
+    static const int INSTR_ALIGN_SHIFT = 1;
+
     // base address subtracted before lookup into array
     uint64_t baseaddr;
     std::vector<Instr *> progtext;
+    std::vector<std::string> labels;
+    std::unordered_map<std::string, uint32_t> label_ids;
+
+    uint32_t internLabel(const std::string &label);
 public:
     ObjdumpedBinary(std::string binaryWithDwarf);
-    Instr* getInstrFromAddr(uint64_t lookupaddress);
+
+    Instr* getInstrFromAddr(uint64_t lookupaddress) {
+        uint64_t computeaddr = (lookupaddress - this->baseaddr) >> INSTR_ALIGN_SHIFT;
+        // addresses below baseaddr wrap around and fail the bounds check
+        if (lookupaddress < this->baseaddr || computeaddr >= this->progtext.size()) {
+            return NULL;
+        }
+        return this->progtext[computeaddr];
+    }
+
+    const std::string& getLabel(uint32_t label_id) { return this->labels[label_id]; }
 };
 
 #endif
@@ -89,19 +89,26 @@ uart_t::~uart_t() {
 
 void uart_t::send() {
     if (data.in.fire()) {
-        write(this->mmio_addrs->in_bits, data.in.bits);
-        write(this->mmio_addrs->in_valid, data.in.valid);
+        mmio_batch.write(this->mmio_addrs->in_bits, data.in.bits);
+        mmio_batch.write(this->mmio_addrs->in_valid, data.in.valid);
     }
     if (data.out.fire()) {
-        write(this->mmio_addrs->out_ready, data.out.ready);
+        mmio_batch.write(this->mmio_addrs->out_ready, data.out.ready);
     }
 }
 
 void uart_t::recv() {
-    data.in.ready = read(this->mmio_addrs->in_ready);
-    data.out.valid = read(this->mmio_addrs->out_valid);
+    // out_bits has no read side effects, so it is fetched along with the
+    // valid bits rather than in a second round trip
+    data_t in_ready, out_valid, out_bits;
+    mmio_batch.read(this->mmio_addrs->in_ready, &in_ready);
+    mmio_batch.read(this->mmio_addrs->out_valid, &out_valid);
+    mmio_batch.read(this->mmio_addrs->out_bits, &out_bits);
+    issue_mmio_batch(mmio_batch);
+    data.in.ready = in_ready;
+    data.out.valid = out_valid;
     if (data.out.valid) {
-        data.out.bits = read(this->mmio_addrs->out_bits);
+        data.out.bits = out_bits;
     }
 }
 
@@ -143,6 +150,7 @@ void uart_t::tick() {
         this->send();
         data.in.valid = false;
     } while(data.in.fire() || data.out.fire());
+    issue_mmio_batch(mmio_batch);
 }
 
 #endif // UARTBRIDGEMODULE_struct_guard
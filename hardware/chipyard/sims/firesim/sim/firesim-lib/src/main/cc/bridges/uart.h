@@ -38,6 +38,8 @@ class uart_t: public bridge_driver_t
         int inputfd;
         int outputfd;
         int loggingfd;
+        // writes queued by send() go out with the next recv()'s reads
+        mmio_batch_t mmio_batch;
         void send();
         void recv();
 };
@@ -43,7 +43,9 @@ autocounter_t::autocounter_t(
         event_addr_lo     (event_addr_lo,      event_addr_lo + event_count),
         event_msgs        (event_msgs,         event_msgs + event_count),
         event_labels      (event_labels,       event_labels + event_count),
-        clock_info(clock_domain_name, clock_multiplier, clock_divisor) {
+        clock_info(clock_domain_name, clock_multiplier, clock_divisor),
+        sample_hi(event_count),
+        sample_lo(event_count) {
 
     this->autocounter_filename = "AUTOCOUNTER";
     const char *autocounter_filename_in = NULL;
@@ -146,10 +148,17 @@ bool autocounter_t::drain_sample() {
   bool bridge_has_sample = read(addr_map.r_registers.at("countersready"));
   if (bridge_has_sample) {
     cur_cycle_base_clock += readrate_base_clock;
+    // Read every counter and acknowledge the sample in one batch
+    for (size_t idx = 0; idx < event_count; idx++) {
+      sample_batch.read(event_addr_hi[idx], &sample_hi[idx]);
+      sample_batch.read(event_addr_lo[idx], &sample_lo[idx]);
+    }
+    sample_batch.write(addr_map.w_registers.at("readdone"), 1);
+    issue_mmio_batch(sample_batch);
+
     autocounter_file << cur_cycle_base_clock << ",";
     for (size_t idx = 0; idx < event_count; idx++) {
-      uint64_t counter_val = ((uint64_t) (read(event_addr_hi[idx]))) << 32;
-      counter_val |= read(event_addr_lo[idx]);
+      uint64_t counter_val = (((uint64_t) sample_hi[idx]) << 32) | sample_lo[idx];
       autocounter_file << counter_val;
 
       if (idx < (event_count - 1)) {
@@ -158,7 +167,6 @@ bool autocounter_t::drain_sample() {
         autocounter_file << std::endl;
       }
     }
-    write(addr_map.w_registers.at("readdone"), 1);
   }
   return bridge_has_sample;
 }
@@ -77,6 +77,10 @@ class autocounter_t: public bridge_driver_t {
         std::vector<std::string> event_msgs;
         std::vector<std::string> event_labels;
         ClockInfo clock_info;
+        // buffers for reading out a sample in a single MMIO batch
+        mmio_batch_t sample_batch;
+        std::vector<data_t> sample_hi;
+        std::vector<data_t> sample_lo;
 
         uint64_t cur_cycle_base_clock = 0;
         uint64_t readrate;
@@ -3,6 +3,8 @@
 #ifndef __BRIDGE_DRIVER_H
 #define __BRIDGE_DRIVER_H
 
+#include <string>
+
 #include "simif.h"
 
 // DOC include start: Bridge Driver Interface
@@ -33,6 +35,13 @@ public:
   // for doing end-of-simulation clean up that requires calling {read,write,push,pull}.
   virtual void finish() = 0;
   // DOC include end: Bridge Driver Interface
+  // Bridges whose tick() may block on host work (file or socket I/O, a
+  // co-simulator) can name a tick domain here. When bridge threads are
+  // enabled (+bridge-threads), each non-empty domain is ticked on its own host
+  // thread, and bridges that share a domain name are ticked one after another
+  // in registration order, which serializes bridges that share host state.
+  // The default, an empty name, ticks on the main simulation thread.
+  virtual std::string tick_domain() { return ""; }
 
 protected:
   void write(size_t addr, data_t data) {
@@ -43,6 +52,10 @@ protected:
     return sim->read(addr);
   }
 
+  void issue_mmio_batch(mmio_batch_t& batch) {
+    sim->issue_mmio_batch(batch);
+  }
+
   ssize_t pull(size_t addr, char *data, size_t size) {
     return sim->pull(addr, data, size);
   }
@@ -0,0 +1,261 @@
+// See LICENSE for license details.
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <gmp.h>
+
+#include "print_formatter.h"
+
+static const char header_tag[] = "# Synthesized Prints Binary:";
+
+print_formatter_t::print_formatter_t(
+  unsigned int print_count,
+  unsigned int token_bytes,
+  unsigned int idle_cycles_mask,
+  const char* const* format_strings,
+  const unsigned int* argument_counts,
+  const unsigned int* argument_widths) :
+    token_bytes(token_bytes),
+    idle_cycles_mask(idle_cycles_mask) {
+  size_t arg_base_offset = 0;
+  size_t print_bit_offset = 1; // The lsb of the current print in the packed token
+
+  mpz_t mask;
+  mpz_init(mask);
+  for (size_t p_idx = 0; p_idx < print_count; p_idx++) {
+    compiled_print_t print;
+    print.enable_bit = print_bit_offset;
+
+    this->format_strings.push_back(format_strings[p_idx]);
+    this->widths.emplace_back(argument_widths + arg_base_offset,
+                              argument_widths + arg_base_offset + argument_counts[p_idx]);
+
+    size_t arg_bit = print_bit_offset + 1;
+    std::vector<size_t> arg_bits;
+    for (auto width: this->widths.back()) {
+      arg_bits.push_back(arg_bit);
+      arg_bit += width;
+    }
+
+    // Mirrors the interpretation of the format string that formatting used
+    // to do for every print
+    const char* fmt = format_strings[p_idx];
+    std::string text;
+    size_t k = 0;
+    while (*fmt) {
+      if (*fmt == '%' && fmt[1] != '%') {
+        assert(k < arg_bits.size());
+        print_arg_t arg;
+        arg.bit = arg_bits[k];
+        arg.width = this->widths.back()[k];
+        arg.pad = 0;
+        // The padding is that of the largest value the argument can hold
+        mpz_set_ui(mask, 1);
+        mpz_mul_2exp(mask, mask, arg.width);
+        mpz_sub_ui(mask, mask, 1);
+        switch (fmt[1]) {
+          case 's':
+          case 'c': arg.kind = ARG_STR; break;
+          case 'h':
+          case 'x': arg.kind = ARG_HEX; arg.pad = mpz_sizeinbase(mask, 16); break;
+          case 'd': arg.kind = ARG_DEC; arg.pad = mpz_sizeinbase(mask, 10); break;
+          case 'b': arg.kind = ARG_BIN; break;
+          default: assert(0); break;
+        }
+        print.segments.push_back(print_segment_t{text, (int)print.args.size()});
+        print.args.push_back(arg);
+        text.clear();
+        fmt += 2;
+        k++;
+      } else if (*fmt == '%') {
+        text.push_back(fmt[1]);
+        fmt += 2;
+      } else if (*fmt == '\\' && fmt[1] == 'n') {
+        text.push_back('\n');
+        fmt += 2;
+      } else {
+        text.push_back(*fmt);
+        fmt++;
+      }
+    }
+    assert(k == arg_bits.size());
+    if (!text.empty()) {
+      print.segments.push_back(print_segment_t{text, -1});
+    }
+
+    prints.push_back(print);
+    arg_base_offset += argument_counts[p_idx];
+    print_bit_offset = arg_bit;
+  }
+  mpz_clear(mask);
+}
+
+static inline bool token_bit(const char* token, size_t bit) {
+  return (token[bit / 8] >> (bit % 8)) & 1;
+}
+
+// Writes <value> in base 2^<log2_base> (2 or 16) ending just before <end>,
+// and returns the number of digits
+static inline size_t to_pow2_base(uint64_t value, int log2_base, char* end) {
+  static const char digits[] = "0123456789abcdef";
+  const uint64_t digit_mask = (1 << log2_base) - 1;
+  size_t n = 0;
+  do {
+    *--end = digits[value & digit_mask];
+    value >>= log2_base;
+    n++;
+  } while (value);
+  return n;
+}
+
+static inline size_t to_decimal(uint64_t value, char* end) {
+  size_t n = 0;
+  do {
+    *--end = '0' + (value % 10);
+    value /= 10;
+    n++;
+  } while (value);
+  return n;
+}
+
+static inline void append_padded(std::string& out, const char* digits, size_t n, size_t pad, char fill) {
+  if (pad > n) out.append(pad - n, fill);
+  out.append(digits, n);
+}
+
+void print_formatter_t::append_cycle_prefix(uint64_t cycle, std::string& out) const {
+  // Equivalent to << "CYCLE:" << std::setw(13) << cycle << " "
+  char buf[24];
+  size_t n = to_decimal(cycle, buf + sizeof(buf));
+  out.append("CYCLE:");
+  append_padded(out, buf + sizeof(buf) - n, n, 13, ' ');
+  out.push_back(' ');
+}
+
+void print_formatter_t::append_arg(const print_arg_t& arg, const char* token, std::string& out) const {
+  const size_t first_byte = arg.bit / 8;
+  const size_t shift = arg.bit % 8;
+  const size_t num_bytes = (shift + arg.width + 7) / 8;
+
+  if (arg.width <= 64) {
+    uint64_t value = (uint8_t)token[first_byte] >> shift;
+    for (size_t i = 1; i < num_bytes; i++) {
+      value |= ((uint64_t)(uint8_t)token[first_byte + i]) << (8 * i - shift);
+    }
+    if (arg.width < 64) value &= (1ULL << arg.width) - 1;
+
+    char buf[64];
+    char* end = buf + sizeof(buf);
+    size_t n;
+    switch (arg.kind) {
+      case ARG_HEX:
+        n = to_pow2_base(value, 4, end);
+        append_padded(out, end - n, n, arg.pad, '0');
+        break;
+      case ARG_DEC:
+        n = to_decimal(value, end);
+        append_padded(out, end - n, n, arg.pad, ' ');
+        break;
+      case ARG_BIN:
+        n = to_pow2_base(value, 1, end);
+        out.append(end - n, n);
+        break;
+      case ARG_STR:
+        // Most significant byte first, without leading zero bytes
+        n = 0;
+        while (n < 8 && (value >> (8 * n))) n++;
+        for (int i = n - 1; i >= 0; i--) out.push_back((char)(value >> (8 * i)));
+        break;
+    }
+    return;
+  }
+
+  mpz_t value;
+  mpz_init(value);
+  mpz_import(value, num_bytes, -1, 1, 0, 0, token + first_byte);
+  mpz_fdiv_q_2exp(value, value, shift);
+  mpz_fdiv_r_2exp(value, value, arg.width);
+  if (arg.kind == ARG_STR) {
+    size_t size;
+    char* v = (char*)mpz_export(NULL, &size, 1, sizeof(char), 0, 0, value);
+    out.append(v, size);
+    free(v);
+  } else {
+    int base = (arg.kind == ARG_HEX) ? 16 : (arg.kind == ARG_DEC) ? 10 : 2;
+    char* v = mpz_get_str(NULL, base, value);
+    append_padded(out, v, strlen(v), arg.pad, (arg.kind == ARG_HEX) ? '0' : ' ');
+    free(v);
+  }
+  mpz_clear(value);
+}
+
+void print_formatter_t::format_tokens(const char* buf, size_t bytes, uint64_t& cycle, std::string& out) const {
+  for (size_t idx = 0; idx < bytes; idx += token_bytes) {
+    const char* token = buf + idx;
+    // The lsb is set if at least one print in the token is enabled; otherwise
+    // the token encodes a number of idle cycles in its msbs
+    if (token[0] & 1) {
+      for (auto &print: prints) {
+        if (!token_bit(token, print.enable_bit)) continue;
+        if (print_cycle_prefix) append_cycle_prefix(cycle, out);
+        for (auto &segment: print.segments) {
+          out.append(segment.text);
+          if (segment.arg >= 0) append_arg(print.args[segment.arg], token, out);
+        }
+      }
+      cycle++;
+    } else {
+      uint32_t word = 0;
+      memcpy(&word, token, std::min<size_t>(sizeof(word), token_bytes));
+      cycle += (word & idle_cycles_mask) >> 1;
+    }
+  }
+}
+
+// The header is one line with the token layout, then one line per print:
+//   # <argument count> <argument widths...> <format length> <format string>
+// The format string is length-prefixed as it may contain any character.
+void print_formatter_t::write_header(std::ostream& os, uint64_t start_cycle) const {
+  os << header_tag << " " << token_bytes << " " << idle_cycles_mask << " "
+     << start_cycle << " " << prints.size() << "\n";
+  for (size_t i = 0; i < prints.size(); i++) {
+    os << "# " << widths[i].size();
+    for (auto w: widths[i]) os << " " << w;
+    os << " " << format_strings[i].size() << " " << format_strings[i] << "\n";
+  }
+}
+
+print_formatter_t* print_formatter_t::read_header(std::istream& is, uint64_t& start_cycle) {
+  std::string tag(sizeof(header_tag) - 1, '\0');
+  if (!is.read(&tag[0], tag.size()) || tag != header_tag) return NULL;
+
+  unsigned int token_bytes, idle_cycles_mask, print_count;
+  if (!(is >> token_bytes >> idle_cycles_mask >> start_cycle >> print_count)) return NULL;
+  is.ignore(1); // newline
+
+  std::vector<std::string> formats(print_count);
+  std::vector<unsigned int> argument_counts(print_count);
+  std::vector<unsigned int> argument_widths;
+  for (size_t i = 0; i < print_count; i++) {
+    char hash;
+    if (!(is >> hash) || hash != '#') return NULL;
+    if (!(is >> argument_counts[i])) return NULL;
+    for (size_t a = 0; a < argument_counts[i]; a++) {
+      unsigned int width;
+      if (!(is >> width)) return NULL;
+      argument_widths.push_back(width);
+    }
+    size_t length;
+    if (!(is >> length)) return NULL;
+    is.ignore(1); // space
+    formats[i].resize(length);
+    if (length && !is.read(&formats[i][0], length)) return NULL;
+    is.ignore(1); // newline
+  }
+
+  std::vector<const char*> format_ptrs;
+  for (auto &f: formats) format_ptrs.push_back(f.c_str());
+  return new print_formatter_t(print_count, token_bytes, idle_cycles_mask,
+                               format_ptrs.data(), argument_counts.data(), argument_widths.data());
+}
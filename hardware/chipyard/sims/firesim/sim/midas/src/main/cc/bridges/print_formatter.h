@@ -0,0 +1,78 @@
+// See LICENSE for license details.
+
+#ifndef __PRINT_FORMATTER_H
+#define __PRINT_FORMATTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Formats the printfs packed into synthesized-print tokens the way a software
+// RTL simulator would have printed them. Used by synthesized_prints_t and by
+// the standalone decode-prints tool, which formats +print-binary output.
+//
+// Format strings are compiled once into literal text and argument slices at
+// fixed bit offsets in the token. Formatting a token then only slices out the
+// arguments of its enabled prints; arguments of up to 64 bits never touch GMP.
+class print_formatter_t
+{
+  public:
+    print_formatter_t(unsigned int print_count,
+                      unsigned int token_bytes,
+                      unsigned int idle_cycles_mask,
+                      const char* const* format_strings,
+                      const unsigned int* argument_counts,
+                      const unsigned int* argument_widths);
+
+    // Appends the text of every enabled print in <bytes> of tokens to <out>,
+    // advancing <cycle> past the target cycles they cover
+    void format_tokens(const char* buf, size_t bytes, uint64_t& cycle, std::string& out) const;
+
+    // Binary output starts with this description of the token layout, after
+    // the clock domain header, so the token stream can be formatted offline
+    void write_header(std::ostream& os, uint64_t start_cycle) const;
+    // Parses a header written by write_header(), leaving <is> at the first
+    // token. Returns NULL if <is> is not at one.
+    static print_formatter_t* read_header(std::istream& is, uint64_t& start_cycle);
+
+    unsigned int get_token_bytes() const { return token_bytes; }
+
+    // Prefix each print with "CYCLE:<cycle> "
+    bool print_cycle_prefix = true;
+
+  private:
+    enum arg_kind_t { ARG_HEX, ARG_DEC, ARG_BIN, ARG_STR };
+
+    struct print_arg_t {
+      arg_kind_t kind;
+      size_t bit;    // lsb of the argument in the token
+      size_t width;  // in bits
+      size_t pad;    // minimum number of digits, as gmp_sprintf would pad
+    };
+
+    // Literal text, followed by an argument unless arg < 0
+    struct print_segment_t {
+      std::string text;
+      int arg;
+    };
+
+    struct compiled_print_t {
+      size_t enable_bit;
+      std::vector<print_arg_t> args;
+      std::vector<print_segment_t> segments;
+    };
+
+    const unsigned int token_bytes;
+    const unsigned int idle_cycles_mask;
+    std::vector<std::string> format_strings;
+    std::vector<std::vector<unsigned int>> widths;
+    std::vector<compiled_print_t> prints;
+
+    void append_cycle_prefix(uint64_t cycle, std::string& out) const;
+    void append_arg(const print_arg_t& arg, const char* token, std::string& out) const;
+};
+
+#endif // __PRINT_FORMATTER_H
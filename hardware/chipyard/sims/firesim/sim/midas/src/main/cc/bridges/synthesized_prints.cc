@@ -1,9 +1,10 @@
 #ifdef PRINTBRIDGEMODULE_struct_guard
 
-#include <iomanip>
-
 #include "synthesized_prints.h"
 
+// The number of batch buffers that can be waiting on the writer thread
+#define NUM_PRINT_BUFS 4
+
 synthesized_prints_t::synthesized_prints_t(
   simif_t* sim,
   std::vector<std::string> &args,
@@ -31,7 +32,9 @@ synthesized_prints_t::synthesized_prints_t(
     argument_widths(argument_widths),
     dma_address(dma_address),
     clock_info(clock_domain_name, clock_multiplier, clock_divisor),
-    printno(printno) {
+    printno(printno),
+    formatter(print_count, token_bytes, idle_cycles_mask,
+              format_strings, argument_counts, argument_widths) {
   assert((token_bytes & (token_bytes - 1)) == 0);
   assert(print_count > 0);
 
@@ -76,7 +79,7 @@ synthesized_prints_t::synthesized_prints_t(
           human_readable = false;
       }
       if (arg.find(cycleprefix_arg) == 0) {
-          print_cycle_prefix = false;
+          formatter.print_cycle_prefix = false;
       }
   }
   current_cycle = start_cycle; // We won't receive tokens until start_cycle; so fast-forward
@@ -89,52 +92,25 @@ synthesized_prints_t::synthesized_prints_t(
 
   this->printstream = &(this->printfile);
   this->clock_info.emit_file_header(*(this->printstream));
-
-  widths.resize(print_count);
-  // Used to reconstruct the relative position of arguments in the flattened argument_widths array
-  size_t arg_base_offset = 0;
-  size_t print_bit_offset = 1; // The lsb of the current print in the packed token
-
-  for (size_t p_idx = 0; p_idx < print_count; p_idx++ ) {
-
-    auto print_args = new print_vars_t;
-    size_t print_width = 1; // A running total of argument widths for this print, including an enable bit
-
-    // Iterate through the arguments for this print
-    for (size_t arg_idx = 0; arg_idx < argument_counts[p_idx]; arg_idx++) {
-      size_t arg_width = argument_widths[arg_base_offset + arg_idx];
-      widths[p_idx].push_back(arg_width);
-
-      mpz_t* mask = (mpz_t*)malloc(sizeof(mpz_t));
-      // Below is equivalent to  *mask = (1 << arg_width) - 1
-      mpz_init(*mask);
-      mpz_set_ui(*mask, 1);
-      mpz_mul_2exp(*mask, *mask, arg_width);
-      mpz_sub_ui(*mask, *mask, 1);
-
-      print_args->data.push_back(mask);
-      print_width += arg_width;
-    }
-
-    size_t aligned_offset = print_bit_offset / gmp_align_bits;
-    size_t aligned_msw = (print_width + print_bit_offset) / gmp_align_bits;
-    size_t rounded_size = aligned_msw - aligned_offset + 1;
-
-    arg_base_offset += argument_counts[p_idx];
-    masks.push_back(print_args);
-    sizes.push_back(rounded_size);
-    aligned_offsets.push_back(aligned_offset);
-    bit_offset.push_back(print_bit_offset % gmp_align_bits);
-
-    print_bit_offset += print_width;
+  // Describe the token layout so the binary output can be formatted offline
+  if (!human_readable) {
+    formatter.write_header(*(this->printstream), start_cycle);
   }
 };
 
 synthesized_prints_t::~synthesized_prints_t() {
-  free(this->mmio_addrs);
-  for (size_t i = 0 ; i < print_count ; i++) {
-      delete masks[i];
+  if (this->writer.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(this->batch_lock);
+      this->writer_done = true;
+    }
+    this->batch_cond.notify_all();
+    this->writer.join();
+  }
+  for (auto buf: this->free_bufs) {
+    free(buf);
   }
+  free(this->mmio_addrs);
 }
 
 void synthesized_prints_t::init() {
@@ -144,71 +120,36 @@ void synthesized_prints_t::init() {
   write(this->mmio_addrs->endCycleL, this->end_cycle);
   write(this->mmio_addrs->endCycleH, this->end_cycle >> 32);
   write(this->mmio_addrs->doneInit, 1);
-}
 
-// Accepts the format string, and the masked arguments, and emits the formatted
-// print to the desired stream
-void synthesized_prints_t::print_format(const char* fmt, print_vars_t* vars, print_vars_t* masks) {
-  size_t k = 0;
-  if (print_cycle_prefix) {
-    *printstream << "CYCLE:" << std::setw(13) << current_cycle << " ";
-  }
-  while(*fmt) {
-    if (*fmt == '%' && fmt[1] != '%') {
-      mpz_t* value = vars->data[k];
-      char* v = NULL;
-      if (fmt[1] == 's' || fmt[1] == 'c') {
-        size_t size;
-        v = (char*)mpz_export(NULL, &size, 1, sizeof(char), 0, 0, *value);
-        for (size_t j = 0 ; j < size ; j++) printstream->put(v[j]);
-        fmt++;
-        free(v);
-      } else {
-        char buf[1024];
-        switch(*(++fmt)) {
-          case 'h':
-          case 'x': gmp_sprintf(buf, "%0*Zx", mpz_sizeinbase(*(masks->data[k]), 16), *value); break;
-          case 'd': gmp_sprintf(buf, "%*Zd",  mpz_sizeinbase(*(masks->data[k]), 10), *value); break;
-          case 'b': mpz_get_str(buf, 2, *value); break;
-          default: assert(0); break;
-        }
-        (*printstream) << buf;
-      }
-      fmt++;
-      k++;
-    } else if (*fmt == '%') {
-      printstream->put(*(++fmt));
-      fmt++;
-    } else if (*fmt == '\\' && fmt[1] == 'n') {
-      printstream->put('\n');
-      fmt += 2;
-    } else {
-      printstream->put(*fmt);
-      fmt++;
-    }
+  // See FireSim issue #208
+  // These need to be page aligned, as a DMA request that spans a page is
+  // fractured into a pair, and for reasons unknown, first beat of the second
+  // request is lost. Once aligned, qequests larger than a page will be fractured into
+  // page-size (64-beat) requests and these seem to behave correctly.
+  size_t batch_bytes = batch_beats * beat_bytes;
+  for (int i = 0; i < NUM_PRINT_BUFS; i++) {
+    void * buf = aligned_alloc(4096, (batch_bytes + 4095) & ~(size_t)4095);
+    assert(buf);
+    this->free_bufs.push_back((char *)buf);
   }
-  assert(k == vars->data.size());
+  this->writer = std::thread(&synthesized_prints_t::writer_loop, this);
 }
 
-// Returns true if at least one print in the token is enabled in this cycle
-bool has_enabled_print(char * buf) { return (buf[0] & 1); }
-// If the token has no enabled prints, return a number of idle cycles encoded in the msbs
-uint32_t decode_idle_cycles(char * buf, uint32_t mask) {
-  return (((*((uint32_t*)buf)) & mask) >> 1);
-}
-
-// Iterates through the DMA flits (each is one token); checking if their are enabled prints
+// Pulls <beats> DMA beats (each holds one or more tokens) and hands them to
+// the writer thread
 void synthesized_prints_t::process_tokens(size_t beats) {
   size_t batch_bytes = beats * beat_bytes;
+  assert(beats <= batch_beats);
+
+  char * buf;
+  {
+    std::unique_lock<std::mutex> lock(this->batch_lock);
+    this->batch_cond.wait(lock, [this] { return !this->free_bufs.empty(); });
+    buf = this->free_bufs.back();
+    this->free_bufs.pop_back();
+  }
 
-  // See FireSim issue #208
-  // This needs to be page aligned, as a DMA request that spans a page is
-  // fractured into a pair, and for reasons unknown, first beat of the second
-  // request is lost. Once aligned, qequests larger than a page will be fractured into
-  // page-size (64-beat) requests and these seem to behave correctly.
-  alignas(4096) char buf[batch_bytes];
-
-  uint32_t bytes_received = pull(dma_address, (char*)buf, batch_bytes);
+  uint32_t bytes_received = pull(dma_address, buf, batch_bytes);
   if (bytes_received != batch_bytes) {
     printf("ERR MISMATCH! on reading print tokens. Read %d bytes, wanted %d bytes.\n",
            bytes_received, batch_bytes);
@@ -216,51 +157,43 @@ void synthesized_prints_t::process_tokens(size_t beats) {
     exit(1);
   }
 
-  if (human_readable) {
-    for (size_t idx = 0; idx < batch_bytes; idx += token_bytes ) {
-      if (has_enabled_print(&buf[idx])) {
-        show_prints(&buf[idx]);
-        current_cycle++;
-      } else {
-        current_cycle += decode_idle_cycles(&buf[idx], idle_cycles_mask);
-      }
-    }
-  } else {
-    printstream->write(buf, batch_bytes);
+  {
+    std::lock_guard<std::mutex> lock(this->batch_lock);
+    this->full_batches.push_back({buf, batch_bytes});
   }
+  this->batch_cond.notify_all();
 }
 
-// Returns true if the print at the current offset is enabled in this cycle
-bool synthesized_prints_t::current_print_enabled(gmp_align_t * buf, size_t offset) {
-  return (buf[0] & (1LL << (offset)));
-}
+void synthesized_prints_t::writer_loop() {
+  while (true) {
+    print_batch_t batch;
+    {
+      std::unique_lock<std::mutex> lock(this->batch_lock);
+      this->batch_cond.wait(lock, [this] { return this->writer_done || !this->full_batches.empty(); });
+      if (this->full_batches.empty()) {
+        return;
+      }
+      batch = this->full_batches.front();
+      this->full_batches.pop_front();
+    }
 
-// Finds enabled prints in a token
-void synthesized_prints_t::show_prints(char * buf) {
-  for (size_t i = 0 ; i < print_count; i++) {
-    gmp_align_t* data = ((gmp_align_t*)buf) + aligned_offsets[i];
-    // First bit is enable
-    if (current_print_enabled(data, bit_offset[i])) {
-      mpz_t print;
-      mpz_init(print);
-      mpz_import(print, sizes[i], -1, sizeof(gmp_align_t), 0, 0, data);
-      mpz_fdiv_q_2exp(print, print, bit_offset[i] + 1);
+    write_tokens(batch.buf, batch.bytes);
 
-      print_vars_t vars;
-      size_t num_args = argument_counts[i];
-      for (size_t arg = 0 ; arg < num_args ; arg++) {
-        mpz_t* var = (mpz_t*)malloc(sizeof(mpz_t));
-        mpz_t* mask = masks[i]->data[arg];
-        mpz_init(*var);
-        // *var = print & *mask
-        mpz_and(*var, print, *mask);
-        vars.data.push_back(var);
-        // print = print >> width
-        mpz_fdiv_q_2exp(print, print, widths[i][arg]);
-      }
-      print_format(format_strings[i], &vars, masks[i]);
-      mpz_clear(print);
+    {
+      std::lock_guard<std::mutex> lock(this->batch_lock);
+      this->free_bufs.push_back(batch.buf);
     }
+    this->batch_cond.notify_all();
+  }
+}
+
+void synthesized_prints_t::write_tokens(const char * buf, size_t bytes) {
+  if (human_readable) {
+    formatted.clear();
+    formatter.format_tokens(buf, bytes, current_cycle, formatted);
+    printstream->write(formatted.data(), formatted.size());
+  } else {
+    printstream->write(buf, bytes);
   }
 }
 
@@ -299,7 +232,17 @@ void synthesized_prints_t::flush() {
     beats_available++;
   }
 
-  if (beats_available) process_tokens(beats_available);
+  while (beats_available) {
+    size_t beats = std::min(beats_available, batch_beats);
+    process_tokens(beats);
+    beats_available -= beats;
+  }
+
+  // Wait for the writer to drain every batch before flushing the file
+  {
+    std::unique_lock<std::mutex> lock(this->batch_lock);
+    this->batch_cond.wait(lock, [this] { return this->free_bufs.size() == NUM_PRINT_BUFS; });
+  }
   this->printstream->flush();
 }
 
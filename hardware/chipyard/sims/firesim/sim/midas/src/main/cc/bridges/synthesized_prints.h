@@ -4,12 +4,16 @@
 #ifdef PRINTBRIDGEMODULE_struct_guard
 
 #include <vector>
+#include <deque>
 #include <iostream>
 #include <fstream>
-#include <gmp.h>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #include "bridge_driver.h"
 #include "clock_info.h"
+#include "print_formatter.h"
 
 // Bridge Driver Instantiation Template
 #define INSTANTIATE_PRINTF(FUNC,IDX) \
@@ -31,16 +35,6 @@
         PRINTBRIDGEMODULE_ ## IDX ## _clock_divisor, \
         IDX)); \
 
-struct print_vars_t {
-  std::vector<mpz_t*> data;
-  ~print_vars_t() {
-    for (auto& e: data) {
-      mpz_clear(*e);
-      free(e);
-    }
-  }
-};
-
 class synthesized_prints_t: public bridge_driver_t
 {
 
@@ -67,6 +61,7 @@ class synthesized_prints_t: public bridge_driver_t
         virtual int exit_code() { return 0; };
         void flush();
         void finish() { flush(); };
+        virtual std::string tick_domain() { return "synthesized_prints" + std::to_string(printno); };
     private:
         PRINTBRIDGEMODULE_struct * mmio_addrs;
         const unsigned int print_count;
@@ -88,11 +83,22 @@ class synthesized_prints_t: public bridge_driver_t
         // This will be modified to be a multiple of the token size
         const size_t desired_batch_beats = 3072;
 
-        // Used to define the boundaries in the batch buffer at which we'll
-        // initalize GMP types
-        using gmp_align_t = uint64_t;
-        const size_t gmp_align_bits = sizeof(gmp_align_t) * 8;
-
+        // DMA pulls land in one of a small pool of buffers, which a writer
+        // thread then formats (or, with +print-binary, copies) to the print
+        // file, so formatting and file I/O stall the bridge only when every
+        // buffer is in flight.
+        struct print_batch_t {
+            char * buf;
+            size_t bytes;
+        };
+        std::vector<char *> free_bufs;
+        std::deque<print_batch_t> full_batches;
+        std::mutex batch_lock;
+        std::condition_variable batch_cond;
+        std::thread writer;
+        bool writer_done = false;
+        // Owned by the writer thread while it runs
+        std::string formatted;
 
         // +arg driven members
         std::ofstream printfile;   // Used only if the +print-file arg is provided
@@ -102,19 +108,12 @@ class synthesized_prints_t: public bridge_driver_t
         uint64_t start_cycle, end_cycle; // Bounds between which prints will be emitted
         uint64_t current_cycle = 0;
         bool human_readable = true;
-        bool print_cycle_prefix = true;
-
-        std::vector<std::vector<size_t>> widths;
-        std::vector<size_t> sizes;
-        std::vector<print_vars_t*> masks;
 
-        std::vector<size_t> aligned_offsets; // Aligned to gmp_align_t
-        std::vector<size_t> bit_offset;
+        print_formatter_t formatter;
 
-        bool current_print_enabled(gmp_align_t* buf, size_t offset);
         void process_tokens(size_t beats);
-        void show_prints(char * buf);
-        void print_format(const char* fmt, print_vars_t* vars, print_vars_t* masks);
+        void write_tokens(const char * buf, size_t bytes);
+        void writer_loop();
         // Returns the number of beats available, once two successive reads return the same value
         int beats_avaliable_stable();
 };
@@ -8,14 +8,14 @@
 
 void mmio_t::read_req(uint64_t addr, size_t size, size_t len) {
   mmio_req_addr_t ar(0, addr, size, len);
-  this->ar.push(ar);
+  this->ar.push_back(ar);
 }
 
 void mmio_t::write_req(uint64_t addr, size_t size, size_t len, void* data, size_t *strb) {
   int nbytes = 1 << size;
 
   mmio_req_addr_t aw(0, addr, size, len);
-  this->aw.push(aw);
+  this->aw.push_back(aw);
 
   for (int i = 0; i < len + 1; i++) {
     mmio_req_data_t w(((char*) data) + i * nbytes, strb[i], i == len);
@@ -41,14 +41,12 @@ void mmio_t::tick(
   const bool r_fire = !reset && r_valid && r_ready();
   const bool b_fire = !reset && b_valid && b_ready();
 
-  if (ar_fire) read_inflight = true;
-  if (aw_fire) write_inflight = true;
+  if (ar_fire) reads_inflight++;
+  if (aw_fire) writes_inflight++;
   if (w_fire) this->w.pop();
   if (r_fire) {
-    char* dat = (char*)malloc(dummy_data.size());
-    memcpy(dat, (char*)r_data, dummy_data.size());
-    mmio_resp_data_t r(r_id, dat, r_last);
-    this->r.push(r);
+    this->r_data.insert(this->r_data.end(), (char*)r_data, (char*)r_data + dummy_data.size());
+    this->r_last.push_back(r_last);
   }
   if (b_fire) {
     this->b.push(b_id);
@@ -56,20 +54,32 @@ void mmio_t::tick(
 }
 
 bool mmio_t::read_resp(void* data) {
-  if (ar.empty() || r.size() <= ar.front().len) {
+  if (ar.empty() || r_last.size() <= ar.front().len) {
     return false;
   } else {
     auto ar = this->ar.front();
     size_t word_size = 1 << ar.size;
+    size_t beat_size = dummy_data.size();
+    const char* beats = &r_data[r_head * beat_size];
+    if (word_size == beat_size) {
+      memcpy(data, beats, (ar.len + 1) * beat_size);
+    } else {
+      for (size_t i = 0 ; i <= ar.len ; i++) {
+        memcpy(((char*)data) + i * word_size, beats + i * beat_size, word_size);
+      }
+    }
     for (size_t i = 0 ; i <= ar.len ; i++) {
-      auto r = this->r.front();
-      assert(i < ar.len || r.last);
-      memcpy(((char*)data) + i * word_size, r.data, word_size);
-      free(r.data);
-      this->r.pop();
+      assert(i < ar.len || r_last.front());
+      r_last.pop_front();
+    }
+    r_head += ar.len + 1;
+    if (r_last.empty()) {
+      r_data.clear();
+      r_head = 0;
     }
-    this->ar.pop();
-    read_inflight = false;
+    this->ar.pop_front();
+    reads_inflight--;
+    host_wait = WAIT_NONE;
     return true;
   }
 }
@@ -78,9 +88,10 @@ bool mmio_t::write_resp() {
   if (aw.empty() || b.empty()) {
     return false;
   } else {
-    aw.pop();
+    aw.pop_front();
     b.pop();
-    write_inflight = false;
+    writes_inflight--;
+    host_wait = WAIT_NONE;
     return true;
   }
 }
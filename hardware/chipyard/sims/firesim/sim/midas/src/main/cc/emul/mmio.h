@@ -9,6 +9,7 @@
 #include <cstring>
 #include <vector>
 #include <queue>
+#include <deque>
 
 struct mmio_req_addr_t
 {
@@ -31,42 +32,34 @@ struct mmio_req_data_t
     data(data_), strb(strb_), last(last_) { }
 };
 
-struct mmio_resp_data_t
-{
-  size_t id;
-  char* data;
-  bool last;
-
-  mmio_resp_data_t(size_t id_, char* data_, bool last_):
-    id(id_), data(data_), last(last_) { }
-};
-
 class mmio_t
 {
 public:
-  mmio_t(size_t size): read_inflight(false), write_inflight(false) {
+  mmio_t(size_t size): reads_inflight(0), writes_inflight(0), r_head(0), host_wait(WAIT_NONE) {
     dummy_data.resize(size);
   }
 
-  bool aw_valid() { return !aw.empty() && !write_inflight; }
-  size_t aw_id() { return aw_valid() ? aw.front().id : 0; }
-  uint64_t aw_addr() { return aw_valid() ? aw.front().addr : 0; }
-  size_t aw_size() { return aw_valid() ? aw.front().size : 0; }
-  size_t aw_len() { return aw_valid() ? aw.front().len : 0; }
+  // Requests are presented to the target back to back: a queued request
+  // does not wait for the previous one's response before it is issued.
+  bool aw_valid() { return aw.size() > writes_inflight; }
+  size_t aw_id() { return aw_valid() ? aw[writes_inflight].id : 0; }
+  uint64_t aw_addr() { return aw_valid() ? aw[writes_inflight].addr : 0; }
+  size_t aw_size() { return aw_valid() ? aw[writes_inflight].size : 0; }
+  size_t aw_len() { return aw_valid() ? aw[writes_inflight].len : 0; }
 
-  bool ar_valid() { return !ar.empty() && !read_inflight; }
-  size_t ar_id() { return ar_valid() ? ar.front().id : 0; }
-  uint64_t ar_addr() { return ar_valid() ? ar.front().addr : 0; }
-  size_t ar_size() { return ar_valid() ? ar.front().size : 0; }
-  size_t ar_len() { return ar_valid() ? ar.front().len : 0; }
+  bool ar_valid() { return ar.size() > reads_inflight; }
+  size_t ar_id() { return ar_valid() ? ar[reads_inflight].id : 0; }
+  uint64_t ar_addr() { return ar_valid() ? ar[reads_inflight].addr : 0; }
+  size_t ar_size() { return ar_valid() ? ar[reads_inflight].size : 0; }
+  size_t ar_len() { return ar_valid() ? ar[reads_inflight].len : 0; }
 
   bool w_valid() { return !w.empty(); }
   size_t w_strb() { return w_valid() ? w.front().strb : 0; }
   bool w_last() { return w_valid() ? w.front().last : false; }
   void* w_data() { return w_valid() ? w.front().data : &dummy_data[0]; }
 
-  bool r_ready() { return read_inflight; }
-  bool b_ready() { return write_inflight; }
+  bool r_ready() { return reads_inflight > 0; }
+  bool b_ready() { return writes_inflight > 0; }
 
   void tick
   (
@@ -87,16 +80,41 @@ public:
   virtual bool read_resp(void *data);
   virtual bool write_resp();
 
+  // Marks the host as blocked until the oldest outstanding read (or write)
+  // has its response. A harness that runs the target in a context of its own
+  // (VCS) keeps stepping the target while host_blocked() instead of switching
+  // back to the host every cycle. Cleared by the read_resp() / write_resp()
+  // call that returns that response.
+  void wait_read_resp() { host_wait = WAIT_READ; }
+  void wait_write_resp() { host_wait = WAIT_WRITE; }
+  bool host_blocked() {
+    switch (host_wait) {
+      case WAIT_READ: return r_last.size() <= ar.front().len;
+      case WAIT_WRITE: return b.empty();
+      default: return false;
+    }
+  }
+
 private:
-  std::queue<mmio_req_addr_t> ar;
-  std::queue<mmio_req_addr_t> aw;
+  // Requests stay queued until their response has been consumed; the first
+  // <reads|writes>_inflight entries have already been accepted by the target.
+  std::deque<mmio_req_addr_t> ar;
+  std::deque<mmio_req_addr_t> aw;
   std::queue<mmio_req_data_t> w;
-  std::queue<mmio_resp_data_t> r;
   std::queue<size_t> b;
 
-  bool read_inflight;
-  bool write_inflight;
+  size_t reads_inflight;
+  size_t writes_inflight;
   std::vector<char> dummy_data;
+
+  // Read response beats, packed back to back in arrival order, and whether
+  // each one was the last of its burst. The first r_head beats in r_data
+  // have already been returned by read_resp().
+  std::vector<char> r_data;
+  std::deque<bool> r_last;
+  size_t r_head;
+
+  enum { WAIT_NONE, WAIT_READ, WAIT_WRITE } host_wait;
 };
 void init(uint64_t memsize, bool dram);
 void load_mems(const char *fname);
@@ -298,7 +298,11 @@ void tick(
     MEMORY_CHANNEL_TICK(3)
 #endif
 
-    if (!vcs_fin) host->switch_to();
+    // A host blocked on a response has nothing to do until it arrives, so
+    // keep stepping the target instead of switching contexts every cycle
+    if (!vcs_fin) {
+      if (!m->host_blocked() && !d->host_blocked()) host->switch_to();
+    }
     else vcs_fin = false;
 
     vc_putScalar(ctrl_aw_valid, m->aw_valid());
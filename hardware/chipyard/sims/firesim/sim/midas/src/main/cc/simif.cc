@@ -52,7 +52,20 @@ void simif_t::init(int argc, char** argv) {
   record_start_times();
 }
 
+void simif_t::issue_mmio_batch(mmio_batch_t& batch) {
+  std::lock_guard<std::recursive_mutex> guard(host_lock);
+  for (auto &access: batch.accesses) {
+    if (access.dest) {
+      *access.dest = read(access.addr);
+    } else {
+      write(access.addr, access.data);
+    }
+  }
+  batch.clear();
+}
+
 uint64_t simif_t::actual_tcycle() {
+    std::lock_guard<std::recursive_mutex> guard(host_lock);
     write(this->clock_bridge_mmio_addrs->tCycle_latch, 1);
     data_t cycle_l = read(this->clock_bridge_mmio_addrs->tCycle_0);
     data_t cycle_h = read(this->clock_bridge_mmio_addrs->tCycle_1);
@@ -60,6 +73,7 @@ uint64_t simif_t::actual_tcycle() {
 }
 
 uint64_t simif_t::hcycle() {
+    std::lock_guard<std::recursive_mutex> guard(host_lock);
     write(this->clock_bridge_mmio_addrs->hCycle_latch, 1);
     data_t cycle_l = read(this->clock_bridge_mmio_addrs->hCycle_0);
     data_t cycle_h = read(this->clock_bridge_mmio_addrs->hCycle_1);
@@ -93,6 +107,7 @@ void simif_t::load_mem(std::string filename) {
 
 // NB: mpz_t variables may not export <size> <data_t> beats, if initialized with an array of zeros.
 void simif_t::read_mem(size_t addr, mpz_t& value) {
+  std::lock_guard<std::recursive_mutex> guard(host_lock);
   write(this->loadmem_mmio_addrs->R_ADDRESS_H, addr >> 32);
   write(this->loadmem_mmio_addrs->R_ADDRESS_L, addr & ((1ULL << 32) - 1));
   const size_t size = MEM_DATA_CHUNK;
@@ -104,6 +119,7 @@ void simif_t::read_mem(size_t addr, mpz_t& value) {
 }
 
 void simif_t::write_mem(size_t addr, mpz_t& value) {
+  std::lock_guard<std::recursive_mutex> guard(host_lock);
   write(this->loadmem_mmio_addrs->W_ADDRESS_H, addr >> 32);
   write(this->loadmem_mmio_addrs->W_ADDRESS_L, addr & ((1ULL << 32) - 1));
   write(this->loadmem_mmio_addrs->W_LENGTH, 1);
@@ -118,6 +134,7 @@ void simif_t::write_mem(size_t addr, mpz_t& value) {
 #define ceil_div(a, b) (((a) - 1) / (b) + 1)
 
 void simif_t::write_mem_chunk(size_t addr, mpz_t& value, size_t bytes) {
+  std::lock_guard<std::recursive_mutex> guard(host_lock);
   write(this->loadmem_mmio_addrs->W_ADDRESS_H, addr >> 32);
   write(this->loadmem_mmio_addrs->W_ADDRESS_L, addr & ((1ULL << 32) - 1));
   size_t num_beats = ceil_div(bytes, MEM_DATA_CHUNK_BYTES);
@@ -130,6 +147,7 @@ void simif_t::write_mem_chunk(size_t addr, mpz_t& value, size_t bytes) {
 }
 
 void simif_t::zero_out_dram() {
+  std::lock_guard<std::recursive_mutex> guard(host_lock);
   write(this->loadmem_mmio_addrs->ZERO_OUT_DRAM, 1);
   while(!read(this->loadmem_mmio_addrs->ZERO_FINISHED));
 }
@@ -7,8 +7,10 @@
 #include <cstring>
 #include <sstream>
 #include <map>
+#include <mutex>
 #include <queue>
 #include <random>
+#include <vector>
 #include <gmp.h>
 #include <sys/time.h>
 #define TIME_DIV_CONST 1000000.0;
@@ -21,6 +23,27 @@ double diff_secs(midas_time_t end, midas_time_t start);
 typedef std::map< std::string, size_t > idmap_t;
 typedef std::map< std::string, size_t >::const_iterator idmap_it_t;
 
+// A queue of MMIO register accesses that a host platform may issue as a
+// single burst instead of one round trip per access. Accesses take effect in
+// the order they were queued; read results are written to the destinations
+// passed to read() once the batch has been issued.
+class mmio_batch_t
+{
+  public:
+    struct access_t {
+      size_t addr;
+      data_t data;
+      data_t *dest; // NULL for writes
+    };
+
+    void read(size_t addr, data_t *dest) { accesses.push_back({addr, 0, dest}); }
+    void write(size_t addr, data_t data) { accesses.push_back({addr, data, NULL}); }
+    bool empty() const { return accesses.empty(); }
+    void clear() { accesses.clear(); }
+
+    std::vector<access_t> accesses;
+};
+
 class simif_t
 {
   public:
@@ -64,6 +87,10 @@ class simif_t
     // 32b MMIO, issued over the simulation control bus (AXI4-lite).
     virtual void write(size_t addr, data_t data) = 0;
     virtual data_t read(size_t addr) = 0;
+    // Issues every access in <batch>, in order, and then empties it. The
+    // default issues them one at a time; platforms that can overlap or
+    // coalesce accesses override this.
+    virtual void issue_mmio_batch(mmio_batch_t& batch);
 
     // Bulk transfers / bridge streaming interfaces.
 
@@ -75,8 +102,19 @@ class simif_t
     // address <addr> (on the FPGA.
     virtual ssize_t push(size_t addr, char *data, size_t size) = 0;
 
+    // Returns true if the accesses above may be issued from threads other than
+    // the one that called init(). Platforms that do so must hold host_lock
+    // around each access; see simif_f1. Platforms that step a software RTL
+    // simulator from the calling thread keep every access on the main thread.
+    virtual bool supports_threaded_host_access() { return false; }
+
     // End host-platform interface.
 
+    // Serializes host accesses when bridge drivers tick on more than one
+    // thread. The multi-access helpers below hold it across their whole
+    // sequence, so it must be recursive.
+    std::recursive_mutex host_lock;
+
     // LOADMEM functions
     void read_mem(size_t addr, mpz_t& value);
     void write_mem(size_t addr, mpz_t& value);
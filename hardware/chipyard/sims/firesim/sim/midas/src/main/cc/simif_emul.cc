@@ -11,6 +11,8 @@
 #endif
 #endif
 #include <signal.h>
+#include <inttypes.h>
+#include <chrono>
 
 uint64_t main_time = 0;
 std::unique_ptr<mmio_t> master;
@@ -113,6 +115,12 @@ void simif_emul_t::host_init(int argc, char** argv) {
 }
 
 int simif_emul_t::host_finish() {
+  if (pull_bytes) {
+    fprintf(stderr, "DMA pull: %" PRIu64 " B, %.1f host ns/B\n", pull_bytes, (double) pull_ns / pull_bytes);
+  }
+  if (push_bytes) {
+    fprintf(stderr, "DMA push: %" PRIu64 " B, %.1f host ns/B\n", push_bytes, (double) push_ns / push_bytes);
+  }
   ::finish();
   return 0;
 }
@@ -129,10 +137,12 @@ void simif_emul_t::advance_target() {
 }
 
 void simif_emul_t::wait_write(std::unique_ptr<mmio_t>& mmio) {
+  mmio->wait_write_resp();
   while(!mmio->write_resp()) advance_target();
 }
 
 void simif_emul_t::wait_read(std::unique_ptr<mmio_t>& mmio, void *data) {
+  mmio->wait_read_resp();
   while(!mmio->read_resp(data)) advance_target();
 }
 
@@ -150,25 +160,72 @@ data_t simif_emul_t::read(size_t addr) {
   return data;
 }
 
+// Consecutive accesses of the same kind are all queued on the control bus
+// before waiting on any of their responses, so the target sees them back to
+// back. A change between reads and writes drains what is outstanding first,
+// since the bus gives no ordering between its read and write channels.
+void simif_emul_t::issue_mmio_batch(mmio_batch_t& batch) {
+  size_t strb = (1 << CTRL_STRB_BITS) - 1;
+  auto &accesses = batch.accesses;
+  size_t start = 0;
+  while (start < accesses.size()) {
+    bool is_read = accesses[start].dest != NULL;
+    size_t end = start;
+    while (end < accesses.size() && (accesses[end].dest != NULL) == is_read) {
+      if (is_read) {
+        master->read_req(accesses[end].addr, CTRL_AXI4_SIZE, 0);
+      } else {
+        master->write_req(accesses[end].addr, CTRL_AXI4_SIZE, 0, &accesses[end].data, &strb);
+      }
+      end++;
+    }
+    for (size_t i = start; i < end; i++) {
+      if (is_read) {
+        wait_read(master, accesses[i].dest);
+      } else {
+        wait_write(master);
+      }
+    }
+    start = end;
+  }
+  batch.clear();
+}
+
 #define MAX_LEN 255
 
+static uint64_t host_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Every burst of a transfer is queued before waiting on the first response,
+// so the target sees them back to back and the host waits once per burst
+// rather than once per round trip.
 ssize_t simif_emul_t::pull(size_t addr, char* data, size_t size) {
+  uint64_t start = host_ns();
   ssize_t len = (size - 1) / DMA_BEAT_BYTES;
+  size_t first_len = len % (MAX_LEN + 1);
 
-  while (len >= 0) {
-      size_t part_len = len % (MAX_LEN + 1);
-
+  for (ssize_t remaining = len; remaining >= 0; ) {
+      size_t part_len = remaining % (MAX_LEN + 1);
       dma->read_req(addr, DMA_SIZE, part_len);
-      wait_read(dma, data);
+      remaining -= (part_len + 1);
+      addr += (part_len + 1) * DMA_BEAT_BYTES;
+  }
 
+  for (size_t part_len = first_len; len >= 0; part_len = MAX_LEN) {
+      wait_read(dma, data);
       len -= (part_len + 1);
-      addr += (part_len + 1) * DMA_BEAT_BYTES;
       data += (part_len + 1) * DMA_BEAT_BYTES;
   }
+
+  pull_bytes += size;
+  pull_ns += host_ns() - start;
   return size;
 }
 
 ssize_t simif_emul_t::push(size_t addr, char *data, size_t size) {
+  uint64_t start = host_ns();
   ssize_t len = (size - 1) / DMA_BEAT_BYTES;
   size_t remaining = size - len * DMA_BEAT_BYTES;
   size_t strb[len + 1];
@@ -182,11 +239,12 @@ ssize_t simif_emul_t::push(size_t addr, char *data, size_t size) {
   else
       strb[len] = (1LL << remaining) - 1;
 
+  size_t bursts = 0;
   while (len >= 0) {
       size_t part_len = len % (MAX_LEN + 1);
 
       dma->write_req(addr, DMA_SIZE, part_len, data, strb_ptr);
-      wait_write(dma);
+      bursts++;
 
       len -= (part_len + 1);
       addr += (part_len + 1) * DMA_BEAT_BYTES;
@@ -194,5 +252,9 @@ ssize_t simif_emul_t::push(size_t addr, char *data, size_t size) {
       strb_ptr += (part_len + 1);
   }
 
+  while (bursts--) wait_write(dma);
+
+  push_bytes += size;
+  push_ns += host_ns() - start;
   return size;
 }
@@ -22,6 +22,7 @@ class simif_emul_t : public virtual simif_t
 
     virtual void write(size_t addr, data_t data);
     virtual data_t read(size_t addr);
+    virtual void issue_mmio_batch(mmio_batch_t& batch);
     virtual ssize_t pull(size_t addr, char* data, size_t size);
     virtual ssize_t push(size_t addr, char* data, size_t size);
 
@@ -30,6 +31,10 @@ class simif_emul_t : public virtual simif_t
     // switching back to the driver process. +fuzz-host-timings sets this to a value > 1, introducing random delays
     // in MMIO (read, write) and DMA (push, pull) requests
     int maximum_host_delay = 1;
+    // Bytes moved by, and host time spent in, pull() and push(); reported
+    // as host ns/B by host_finish()
+    uint64_t pull_bytes = 0, pull_ns = 0;
+    uint64_t push_bytes = 0, push_ns = 0;
     void advance_target();
     void wait_read(std::unique_ptr<mmio_t>& mmio, void *data);
     void wait_write(std::unique_ptr<mmio_t>& mmio);
@@ -146,6 +146,7 @@ simif_f1_t::~simif_f1_t() {
 }
 
 void simif_f1_t::write(size_t addr, uint32_t data) {
+    std::lock_guard<std::recursive_mutex> guard(host_lock);
 #ifdef SIMULATION_XSIM
     uint64_t cmd = (((uint64_t)(0x80000000 | addr)) << 32) | (uint64_t)data;
     char * buf = (char*)&cmd;
@@ -157,6 +158,7 @@ void simif_f1_t::write(size_t addr, uint32_t data) {
 }
 
 uint32_t simif_f1_t::read(size_t addr) {
+    std::lock_guard<std::recursive_mutex> guard(host_lock);
 #ifdef SIMULATION_XSIM
     uint64_t cmd = addr;
     char * buf = (char*)&cmd;
@@ -177,7 +179,51 @@ uint32_t simif_f1_t::read(size_t addr) {
 #endif
 }
 
+void simif_f1_t::issue_mmio_batch(mmio_batch_t& batch) {
+    std::lock_guard<std::recursive_mutex> guard(host_lock);
+#ifdef SIMULATION_XSIM
+    // Send every command down the pipe at once, then collect read responses,
+    // which XSIM returns in command order.
+    std::vector<uint64_t> cmds;
+    cmds.reserve(batch.accesses.size());
+    for (auto &access: batch.accesses) {
+        if (access.dest) {
+            cmds.push_back(access.addr);
+        } else {
+            cmds.push_back((((uint64_t)(0x80000000 | access.addr)) << 32) | (uint64_t)access.data);
+        }
+    }
+    ::write(driver_to_xsim_fd, (char*)cmds.data(), cmds.size() * 8);
+
+    for (auto &access: batch.accesses) {
+        if (!access.dest) continue;
+        uint64_t resp;
+        char * buf = (char*)&resp;
+        int gotdata = 0;
+        while (gotdata == 0) {
+            gotdata = ::read(xsim_to_driver_fd, buf, 8);
+            if (gotdata != 0 && gotdata != 8) {
+                printf("ERR GOTDATA %d\n", gotdata);
+            }
+        }
+        *access.dest = resp;
+    }
+#else
+    int rc = 0;
+    for (auto &access: batch.accesses) {
+        if (access.dest) {
+            rc |= fpga_pci_peek(pci_bar_handle, access.addr, access.dest);
+        } else {
+            rc |= fpga_pci_poke(pci_bar_handle, access.addr, access.data);
+        }
+    }
+    check_rc(rc, NULL);
+#endif
+    batch.clear();
+}
+
 ssize_t simif_f1_t::pull(size_t addr, char* data, size_t size) {
+  std::lock_guard<std::recursive_mutex> guard(host_lock);
 #ifdef SIMULATION_XSIM
   return -1; // TODO
 #else
@@ -186,6 +232,7 @@ ssize_t simif_f1_t::pull(size_t addr, char* data, size_t size) {
 }
 
 ssize_t simif_f1_t::push(size_t addr, char* data, size_t size) {
+  std::lock_guard<std::recursive_mutex> guard(host_lock);
 #ifdef SIMULATION_XSIM
   return -1; // TODO
 #else
@@ -20,8 +20,10 @@ class simif_f1_t: public virtual simif_t
 
     virtual void write(size_t addr, uint32_t data);
     virtual uint32_t read(size_t addr);
+    virtual void issue_mmio_batch(mmio_batch_t& batch);
     virtual ssize_t pull(size_t addr, char* data, size_t size);
     virtual ssize_t push(size_t addr, char* data, size_t size);
+    virtual bool supports_threaded_host_access() { return true; }
     uint32_t is_write_ready();
     void check_rc(int rc, char * infostr);
     void fpga_shutdown();
@@ -0,0 +1,152 @@
+//See LICENSE for license details
+#include <algorithm>
+#include <chrono>
+#include <cxxabi.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <typeinfo>
+
+#include "bridge_scheduler.h"
+
+// How many times a waiting thread polls before sleeping on a condition variable
+#define BRIDGE_SCHEDULER_SPIN_ITERS 4096
+
+static uint64_t host_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::string bridge_type_name(bridge_driver_t* bridge) {
+    const char* mangled = typeid(*bridge).name();
+    int status;
+    char* demangled = abi::__cxa_demangle(mangled, NULL, NULL, &status);
+    std::string name = (status == 0) ? demangled : mangled;
+    free(demangled);
+    return name;
+}
+
+void bridge_scheduler_t::add_bridge(bridge_driver_t* bridge) {
+    // Name bridges by driver class and per-class instance, e.g. blockdev_t[0]
+    std::string type = bridge_type_name(bridge) + "[";
+    int instance = 0;
+    for (auto &e: bridges) {
+        if (e.name.compare(0, type.size(), type) == 0) instance++;
+    }
+    bridges.push_back(bridge_entry_t{bridge, type + std::to_string(instance) + "]", "", 0, 0});
+}
+
+void bridge_scheduler_t::start(bool threaded) {
+    for (size_t i = 0; i < bridges.size(); i++) {
+        std::string domain_name = threaded ? bridges[i].bridge->tick_domain() : "";
+        bridges[i].domain = domain_name;
+        if (domain_name.empty()) {
+            main_members.push_back(i);
+            continue;
+        }
+
+        auto it = std::find_if(domains.begin(), domains.end(),
+            [&](const std::unique_ptr<domain_t>& d) { return d->name == domain_name; });
+        if (it == domains.end()) {
+            domains.emplace_back(new domain_t);
+            domains.back()->name = domain_name;
+            it = domains.end() - 1;
+        }
+        (*it)->members.push_back(i);
+    }
+
+    for (auto &d: domains) {
+        fprintf(stderr, "Ticking bridge domain %s on its own thread\n", d->name.c_str());
+        d->thread = std::thread(&bridge_scheduler_t::domain_loop, this, d.get());
+    }
+}
+
+void bridge_scheduler_t::tick_members(const std::vector<size_t>& members) {
+    for (auto i: members) {
+        bridge_entry_t &e = bridges[i];
+        uint64_t start = host_ns();
+        e.bridge->tick();
+        e.tick_ns += host_ns() - start;
+        e.ticks++;
+    }
+}
+
+void bridge_scheduler_t::tick() {
+    passes++;
+    if (domains.empty()) {
+        tick_members(main_members);
+        return;
+    }
+
+    pending.store(domains.size());
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pass++;
+    }
+    start_cond.notify_all();
+
+    tick_members(main_members);
+
+    if (pending.load() == 0) return;
+    uint64_t start = host_ns();
+    for (int i = 0; i < BRIDGE_SCHEDULER_SPIN_ITERS && pending.load() != 0; i++);
+    if (pending.load() != 0) {
+        std::unique_lock<std::mutex> guard(lock);
+        done_cond.wait(guard, [this] { return pending.load() == 0; });
+    }
+    wait_ns += host_ns() - start;
+}
+
+void bridge_scheduler_t::domain_loop(domain_t* domain) {
+    while (true) {
+        uint64_t next = domain->pass + 1;
+        for (int i = 0; i < BRIDGE_SCHEDULER_SPIN_ITERS && pass.load() < next; i++);
+        if (pass.load() < next) {
+            std::unique_lock<std::mutex> guard(lock);
+            start_cond.wait(guard, [&] { return pass.load() >= next; });
+        }
+        if (stopping.load()) return;
+
+        domain->pass = next;
+        tick_members(domain->members);
+
+        if (pending.fetch_sub(1) == 1) {
+            // Notify under the lock so the main thread cannot miss it between
+            // checking pending and going to sleep
+            std::lock_guard<std::mutex> guard(lock);
+            done_cond.notify_one();
+        }
+    }
+}
+
+void bridge_scheduler_t::stop() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping.store(true);
+        pass++;
+    }
+    start_cond.notify_all();
+    for (auto &d: domains) {
+        if (d->thread.joinable()) d->thread.join();
+    }
+}
+
+void bridge_scheduler_t::print_host_time_summary() {
+    std::vector<const bridge_entry_t*> by_time;
+    for (auto &e: bridges) by_time.push_back(&e);
+    std::sort(by_time.begin(), by_time.end(),
+        [](const bridge_entry_t* a, const bridge_entry_t* b) { return a->tick_ns > b->tick_ns; });
+
+    fprintf(stderr, "\nBridge Host Time Summary\n");
+    fprintf(stderr,   "------------------------------\n");
+    for (auto e: by_time) {
+        fprintf(stderr, "%s (%s): %.3f s in %" PRIu64 " ticks\n",
+                e->name.c_str(),
+                e->domain.empty() ? "main thread" : e->domain.c_str(),
+                e->tick_ns / 1e9, e->ticks);
+    }
+    if (!domains.empty()) {
+        fprintf(stderr, "Main thread waiting on bridge domains: %.3f s over %" PRIu64 " passes\n",
+                wait_ns / 1e9, passes);
+    }
+}
@@ -0,0 +1,83 @@
+//See LICENSE for license details
+#ifndef __BRIDGE_SCHEDULER_H
+#define __BRIDGE_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bridges/bridge_driver.h"
+
+// Ticks every registered bridge driver once per call to tick(), in place of
+// the serial loop over bridges in firesim_top_t::run().
+//
+// When threading is enabled, bridges are grouped by their tick_domain().
+// Bridges in the empty domain are ticked on the calling (main) thread; each
+// named domain gets a host thread of its own that ticks its bridges in
+// registration order. tick() returns once every domain has finished, so a
+// bridge blocked on host I/O only holds up the bridges in its own domain for
+// the length of that pass rather than adding to everyone's. Host accesses
+// from the worker threads are serialized by simif_t::host_lock.
+//
+// The host time spent in each bridge's tick() is recorded either way and
+// reported by print_host_time_summary().
+class bridge_scheduler_t
+{
+    public:
+        bridge_scheduler_t() { }
+        ~bridge_scheduler_t() { stop(); }
+
+        void add_bridge(bridge_driver_t* bridge);
+        // Spawns the domain threads. With threaded == false, every bridge is
+        // ticked on the main thread in registration order, as before.
+        void start(bool threaded);
+        // Ticks every bridge once.
+        void tick();
+        // Joins the domain threads. Called before bridges are finish()ed.
+        void stop();
+        void print_host_time_summary();
+
+    private:
+        typedef struct {
+            bridge_driver_t* bridge;
+            std::string name;
+            std::string domain;
+            uint64_t ticks;
+            uint64_t tick_ns;
+        } bridge_entry_t;
+
+        struct domain_t {
+            std::string name;
+            std::vector<size_t> members;
+            std::thread thread;
+            uint64_t pass = 0;
+        };
+
+        std::vector<bridge_entry_t> bridges;
+        // Bridges ticked on the main thread, and the named domains
+        std::vector<size_t> main_members;
+        std::vector<std::unique_ptr<domain_t>> domains;
+
+        // Workers wait for pass to advance, then decrement pending when they
+        // finish it. They spin for a while before sleeping on start_cond, as
+        // passes usually follow each other closely.
+        std::mutex lock;
+        std::condition_variable start_cond;
+        std::condition_variable done_cond;
+        std::atomic<uint64_t> pass{0};
+        std::atomic<size_t> pending{0};
+        std::atomic<bool> stopping{false};
+
+        // Host time the main thread spent waiting on worker domains
+        uint64_t wait_ns = 0;
+        uint64_t passes = 0;
+
+        void tick_members(const std::vector<size_t>& members);
+        void domain_loop(domain_t* domain);
+};
+
+#endif // __BRIDGE_SCHEDULER_H
@@ -37,6 +37,9 @@ firesim_top_t::firesim_top_t(int argc, char** argv)
         if (arg.find("+zero-out-dram") == 0) {
             do_zero_out_dram = true;
         }
+        if (arg.find("+bridge-threads") == 0) {
+            use_bridge_threads = true;
+        }
     }
 
     add_bridge_driver(new heartbeat_t(this, args));
@@ -560,6 +563,12 @@ void firesim_top_t::run() {
         e->init();
     }
 
+    if (use_bridge_threads && !supports_threaded_host_access()) {
+        fprintf(stderr, "+bridge-threads is not supported on this host platform. Ticking all bridges on the main thread.\n");
+        use_bridge_threads = false;
+    }
+    bridge_scheduler.start(use_bridge_threads);
+
     if (do_zero_out_dram) {
         fprintf(stderr, "Zeroing out FPGA DRAM. This will take a few minutes...\n");
         zero_out_dram();
@@ -572,10 +581,11 @@ void firesim_top_t::run() {
         run_scheduled_tasks();
         take_steps(get_largest_stepsize(), false);
         while(!done() && !simulation_complete()){
-            for (auto &e: bridges) e->tick();
+            bridge_scheduler.tick();
         }
     }
 
+    bridge_scheduler.stop();
     record_end_times();
     fprintf(stderr, "\nSimulation complete.\n");
 }
@@ -596,6 +606,7 @@ int firesim_top_t::teardown() {
     }
 
     print_simulation_performance_summary();
+    bridge_scheduler.print_host_time_summary();
 
     for (auto &e: fpga_models) {
         e->finish();
@@ -8,6 +8,7 @@
 #include "bridges/bridge_driver.h"
 #include "bridges/fpga_model.h"
 #include "systematic_scheduler.h"
+#include "bridge_scheduler.h"
 
 #include "bridges/synthesized_prints.h"
 
@@ -23,6 +24,7 @@ class firesim_top_t: virtual simif_t, public systematic_scheduler_t
     protected:
         void add_bridge_driver(bridge_driver_t* bridge_driver) {
             bridges.push_back(std::unique_ptr<bridge_driver_t>(bridge_driver));
+            bridge_scheduler.add_bridge(bridge_driver);
         }
 
     private:
@@ -31,6 +33,11 @@ class firesim_top_t: virtual simif_t, public systematic_scheduler_t
         // FPGA-hosted models with programmable registers & instrumentation
         // (i.e., bridges_drivers whose tick() is a nop)
         std::vector<FpgaModel*> fpga_models;
+        // Ticks the bridges above, on their own threads if use_bridge_threads
+        bridge_scheduler_t bridge_scheduler;
+
+        // If set, bridges that name a tick domain are ticked off the main thread
+        bool use_bridge_threads = false;
 
         // profile interval: # of cycles to advance before profiling instrumentation registers in models
         uint64_t profile_interval = -1;
@@ -0,0 +1,95 @@
+// See LICENSE for license details.
+
+// Formats a synthesized printf trace captured with +print-binary, producing
+// the same output the simulation would have written without it.
+//
+// Usage: decode-prints [--no-cycle-prefix] <binary print file> [<output file>]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "print_formatter.h"
+
+// Tokens are read and formatted this many bytes at a time
+#define DECODE_CHUNK_BYTES (1 << 20)
+
+static void usage(const char* prog) {
+  fprintf(stderr, "Usage: %s [--no-cycle-prefix] <binary print file> [<output file>]\n", prog);
+  exit(1);
+}
+
+int main(int argc, char** argv) {
+  bool print_cycle_prefix = true;
+  std::vector<const char*> files;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--no-cycle-prefix")) {
+      print_cycle_prefix = false;
+    } else if (argv[i][0] == '-' && argv[i][1]) {
+      usage(argv[0]);
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+  if (files.empty() || files.size() > 2) usage(argv[0]);
+
+  std::ifstream in(files[0], std::ios_base::in | std::ios_base::binary);
+  if (!in.is_open()) {
+    fprintf(stderr, "Could not open binary print file: %s\n", files[0]);
+    return 1;
+  }
+
+  std::ofstream outfile;
+  std::ostream* out = &std::cout;
+  if (files.size() == 2) {
+    outfile.open(files[1], std::ios_base::out | std::ios_base::binary);
+    if (!outfile.is_open()) {
+      fprintf(stderr, "Could not open output file: %s\n", files[1]);
+      return 1;
+    }
+    out = &outfile;
+  }
+
+  // Copy the clock domain header through, as the formatted output would have it
+  std::string line;
+  std::unique_ptr<print_formatter_t> formatter;
+  uint64_t cycle;
+  while (in.peek() == '#') {
+    std::streampos start = in.tellg();
+    formatter.reset(print_formatter_t::read_header(in, cycle));
+    if (formatter) break;
+    in.clear();
+    in.seekg(start);
+    std::getline(in, line);
+    *out << line << "\n";
+  }
+  if (!formatter) {
+    fprintf(stderr, "%s has no synthesized print layout header; was it written with +print-binary?\n", files[0]);
+    return 1;
+  }
+  formatter->print_cycle_prefix = print_cycle_prefix;
+
+  // Keep chunks a multiple of the token size
+  const size_t token_bytes = formatter->get_token_bytes();
+  const size_t chunk_bytes = DECODE_CHUNK_BYTES - (DECODE_CHUNK_BYTES % token_bytes);
+  std::vector<char> buf(chunk_bytes);
+  std::string formatted;
+  while (in) {
+    in.read(buf.data(), chunk_bytes);
+    size_t bytes = in.gcount();
+    if (bytes % token_bytes) {
+      fprintf(stderr, "Warning: ignoring %zu trailing bytes of a partial token\n", bytes % token_bytes);
+      bytes -= bytes % token_bytes;
+    }
+    formatted.clear();
+    formatter->format_tokens(buf.data(), bytes, cycle, formatted);
+    out->write(formatted.data(), formatted.size());
+  }
+  out->flush();
+  return 0;
+}
@@ -9,12 +9,31 @@ struct switchpacket {
     uint64_t timestamp;
     uint64_t dat[200];
     int amtwritten;
-    int amtread;
     int sender;
+    // number of output queues still holding this packet. broadcasts are
+    // shared between output ports rather than copied per port
+    int refcount;
 };
 
 typedef struct switchpacket switchpacket;
 
+// an entry in a port's output queue. how much of the packet has been sent
+// is tracked here, since a broadcast packet is shared by many output queues
+struct outputpacket {
+    switchpacket * sp;
+    int amtread;
+};
+
+typedef struct outputpacket outputpacket;
+
+// drop one output queue's reference to a packet, freeing it on the last one.
+// output ports are flushed in parallel, so this has to be atomic
+static void release_switchpacket(switchpacket *sp) {
+    if (__atomic_sub_fetch(&sp->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(sp);
+    }
+}
+
 
 class BasePort {
     public:
@@ -34,12 +53,13 @@ class BasePort {
 
         int pauseCycles = 0;
         int recv_buf_port_map = -1; // used when frame crosses batching boundary. the last port that fed this port's send buf
+        unsigned int uplink_rand_state; // picks an uplink for packets routed from this port
 
         switchpacket * input_in_progress = NULL;
         switchpacket * output_in_progress = NULL;
 
         std::queue<switchpacket*> inputqueue;
-        std::queue<switchpacket*> outputqueue;
+        std::queue<outputpacket> outputqueue;
 
         int push_input(switchpacket *sp);
 
@@ -49,7 +69,7 @@ class BasePort {
 };
 
 BasePort::BasePort(int portNo, bool throttle)
-    : _portNo(portNo), _throttle(throttle)
+    : uplink_rand_state(portNo), _portNo(portNo), _throttle(throttle)
 {
 }
 
@@ -95,7 +115,8 @@ void BasePort::write_flits_to_output() {
     this->pauseCycles -= flitswritten;
 
     while (!(outputqueue.empty())) {
-        switchpacket *thispacket = outputqueue.front();
+        outputpacket &thisentry = outputqueue.front();
+        switchpacket *thispacket = thisentry.sp;
         // first, check timing boundaries.
         uint64_t space_available = LINKLATENCY - flitswritten;
         uint64_t outputtimestamp = thispacket->timestamp;
@@ -107,12 +128,12 @@ void BasePort::write_flits_to_output() {
 #ifdef LIMITED_BUFSIZE
             // output-buffer size-based throttling, based on input time of first flit
             int64_t diff = basetime + flitswritten - outputtimestamp;
-            if ((thispacket->amt_read == 0) && (diff > OUTPUT_BUF_SIZE)) {
+            if ((thisentry.amtread == 0) && (diff > OUTPUT_BUF_SIZE)) {
                 // this packet would've been dropped due to buffer overflow.
                 // so, drop it.
                 printf("overflow, drop pack: intended timestamp: %ld, current timestamp: %ld, out bufsize in # flits: %ld, diff: %ld\n", outputtimestamp, basetime + flitswritten, OUTPUT_BUF_SIZE, (int64_t)(basetime + flitswritten) - (int64_t)(outputtimestamp));
                 outputqueue.pop();
-                free(thispacket);
+                release_switchpacket(thispacket);
                 continue;
             }
 #endif
@@ -122,7 +143,7 @@ void BasePort::write_flits_to_output() {
             uint64_t timestampdiff = outputtimestamp > basetime ? outputtimestamp - basetime : 0L;
             flitswritten = std::max(flitswritten, timestampdiff);
 
-            int i = thispacket->amtread;
+            int i = thisentry.amtread;
             if (i == 0) {
                 //printf("intended timestamp: %ld, actual timestamp: %ld, diff %ld\n", 
                 //        outputtimestamp, basetime + flitswritten, 
@@ -146,11 +167,11 @@ void BasePort::write_flits_to_output() {
             if (i == thispacket->amtwritten) {
                 // we finished sending this packet, so get rid of it
                 outputqueue.pop();
-                free(thispacket);
+                release_switchpacket(thispacket);
             } else {
                 // we're not done sending this packet, so mark how much has been sent
                 // for the next time
-                thispacket->amtread = i;
+                thisentry.amtread = i;
                 break;
             }
         } else {
@@ -49,7 +49,7 @@ void write_valid_flit(uint8_t * send_buf, int tokenid) {
     *lrv |= (1L << bitoffset);
 }
 
-int write_last_flit(uint8_t * send_buf, int tokenid, int is_last) {
+void write_last_flit(uint8_t * send_buf, int tokenid, int is_last) {
     int base = tokenid / TOKENS_PER_BIGTOKEN;
     int offset = tokenid % TOKENS_PER_BIGTOKEN;
 
@@ -58,8 +58,9 @@ int write_last_flit(uint8_t * send_buf, int tokenid, int is_last) {
     *lrv |= (((uint64_t)is_last) << bitoffset);
 }
 
-/* get dest mac from flit, then get port from mac */
-uint16_t get_port_from_flit(uint64_t flit, int current_port) {
+/* get dest mac from flit, then get port from mac. rand_state picks among
+ * the uplinks, and is per input port so ports can be routed in parallel */
+uint16_t get_port_from_flit(uint64_t flit, unsigned int *rand_state) {
     uint16_t is_multicast = (flit >> 16) & 0x1;
     uint16_t flit_low = (flit >> 48) & 0xFFFF; // indicates dest
     uint16_t sendport = (__builtin_bswap16(flit_low));
@@ -76,7 +77,7 @@ uint16_t get_port_from_flit(uint64_t flit, int current_port) {
 
     if (sendport == NUMDOWNLINKS) {
         // this has been mapped to "any uplink", so pick one
-        int randval = rand() % NUMUPLINKS;
+        int randval = rand_r(rand_state) % NUMUPLINKS;
         sendport = randval + NUMDOWNLINKS;
 //        printf("sending to random uplink.\n");
 //        printf("port: %04x\n", sendport);
@@ -1,4 +1,57 @@
 #include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+// Each shared buffer is followed by a cache line holding the flag that hands
+// it to the other side. The flag doubles as a futex word: a reader spins on
+// it for a while and then sleeps in the kernel, so idle ports don't burn
+// host cores that simulations need. This layout must match simplenic.cc.
+#define SHMEM_EXTRABYTES 64
+#define SHMEM_NAME_SIZE 120
+
+// how many times a port polls its flag before sleeping on it.
+// THIS IS SET BY A COMMAND LINE ARGUMENT. DO NOT CHANGE IT HERE.
+int shmem_spin_iters = 4096;
+
+// how many exchanges a port makes between printing its wait statistics
+#define SHMEM_STATS_INTERVAL 100000
+
+struct shmem_flag {
+    uint32_t ready;
+    uint32_t waiters;
+};
+
+static void shmem_flag_post(uint8_t * flagaddr) {
+    struct shmem_flag * flag = (struct shmem_flag *)flagaddr;
+    __atomic_store_n(&flag->ready, 1, __ATOMIC_RELEASE);
+    // pairs with the waiter's increment, so either we see it or it sees ready
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&flag->waiters, __ATOMIC_RELAXED)) {
+        syscall(SYS_futex, &flag->ready, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+}
+
+// returns true if the caller had to sleep
+static bool shmem_flag_wait(uint8_t * flagaddr) {
+    struct shmem_flag * flag = (struct shmem_flag *)flagaddr;
+    for (int i = 0; i < shmem_spin_iters; i++) {
+        if (__atomic_load_n(&flag->ready, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+    }
+    __atomic_add_fetch(&flag->waiters, 1, __ATOMIC_SEQ_CST);
+    while (!__atomic_load_n(&flag->ready, __ATOMIC_ACQUIRE)) {
+        syscall(SYS_futex, &flag->ready, FUTEX_WAIT, 0, NULL, NULL, 0);
+    }
+    __atomic_sub_fetch(&flag->waiters, 1, __ATOMIC_SEQ_CST);
+    return true;
+}
+
+static void shmem_flag_clear(uint8_t * flagaddr) {
+    __atomic_store_n(&((struct shmem_flag *)flagaddr)->ready, 0, __ATOMIC_RELAXED);
+}
 
 class ShmemPort : public BasePort {
     public:
@@ -11,11 +64,15 @@ class ShmemPort : public BasePort {
         uint8_t * recvbufs[2];
         uint8_t * sendbufs[2];
         int currentround = 0;
+
+        // wait statistics, reported every SHMEM_STATS_INTERVAL exchanges
+        uint64_t exchanges = 0;
+        uint64_t spin_waits = 0;
+        uint64_t sleep_waits = 0;
+        uint64_t wait_ns = 0;
 };
 
 ShmemPort::ShmemPort(int portNo, char * shmemportname, bool uplink) : BasePort(portNo, !uplink) {
-#define SHMEM_EXTRABYTES 1
-#define SHMEM_NAME_SIZE 120
 
     // create shared memory regions
     char name[SHMEM_NAME_SIZE];
@@ -143,12 +200,30 @@ void ShmemPort::send() {
         ((uint64_t*)current_output_buf)[0] = 0L;
     }
     // mark flag to initiate "send"
-    current_output_buf[BUFSIZE_BYTES] = 1;
+    shmem_flag_post(current_output_buf + BUFSIZE_BYTES);
 }
 
 void ShmemPort::recv() {
-    volatile uint8_t * polladdr = current_input_buf + BUFSIZE_BYTES;
-    while (*polladdr == 0) { ; } // poll
+    uint8_t * flagaddr = current_input_buf + BUFSIZE_BYTES;
+    exchanges++;
+    if (!__atomic_load_n(&((struct shmem_flag *)flagaddr)->ready, __ATOMIC_ACQUIRE)) {
+        struct timespec tstart, tend;
+        clock_gettime(CLOCK_MONOTONIC, &tstart);
+        if (shmem_flag_wait(flagaddr)) {
+            sleep_waits++;
+        } else {
+            spin_waits++;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &tend);
+        wait_ns += (tend.tv_sec - tstart.tv_sec) * 1000000000L + (tend.tv_nsec - tstart.tv_nsec);
+    }
+
+    if (exchanges % SHMEM_STATS_INTERVAL == 0) {
+        fprintf(stdout, "port %d: %ld exchanges, %ld waited spinning, %ld waited sleeping, avg wait %ld ns\n",
+                _portNo, exchanges, spin_waits, sleep_waits,
+                (spin_waits + sleep_waits) ? wait_ns / (spin_waits + sleep_waits) : 0L);
+        fflush(stdout);
+    }
 }
 
 void ShmemPort::tick_pre() {
@@ -158,7 +233,7 @@ void ShmemPort::tick_pre() {
 
 void ShmemPort::tick() {
     // zero out recv buf flag for next iter
-    current_input_buf[BUFSIZE_BYTES] = 0;
+    shmem_flag_clear(current_input_buf + BUFSIZE_BYTES);
 
     // swap buf pointers
     current_input_buf = recvbufs[currentround];
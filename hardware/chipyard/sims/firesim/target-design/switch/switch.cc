@@ -1,5 +1,6 @@
 #include <functional>
 #include <queue>
+#include <vector>
 #include <algorithm>
 #include <stdio.h>
 #include <string.h>
@@ -85,6 +86,38 @@ uint64_t this_iter_cycles_start = 0;
 
 BasePort * ports[NUMPORTS];
 
+// packets headed for each output port, one timestamp-ordered bucket per
+// input port: route_buckets[output][input]
+std::vector<switchpacket*> route_buckets[NUMPORTS][NUMPORTS];
+
+/* merge the buckets for one output port into its output queue, oldest first.
+ * ties go to the lower-numbered input port */
+void merge_route_buckets(int outport) {
+    typedef std::pair<uint64_t, int> tsinput;
+    std::priority_queue<tsinput, std::vector<tsinput>, std::greater<tsinput> > heads;
+    size_t next[NUMPORTS] = {0};
+    std::vector<switchpacket*> * buckets = route_buckets[outport];
+
+    for (int inport = 0; inport < NUMPORTS; inport++) {
+        if (!buckets[inport].empty()) {
+            heads.push(tsinput(buckets[inport][0]->timestamp, inport));
+        }
+    }
+
+    while (!heads.empty()) {
+        int inport = heads.top().second;
+        heads.pop();
+        ports[outport]->outputqueue.push(outputpacket { buckets[inport][next[inport]], 0 });
+        if (++next[inport] < buckets[inport].size()) {
+            heads.push(tsinput(buckets[inport][next[inport]]->timestamp, inport));
+        }
+    }
+
+    for (int inport = 0; inport < NUMPORTS; inport++) {
+        buckets[inport].clear();
+    }
+}
+
 /* switch from input ports to output ports */
 void do_fast_switching() {
 #pragma omp parallel for
@@ -127,66 +160,49 @@ for (int port = 0; port < NUMPORTS; port++) {
     }
 }
 
-// next do the switching. but this switching is just shuffling pointers,
-// so it should be fast. it has to be serial though...
-
-// NO PARALLEL!
-// shift pointers to output queues, but in order. basically.
-// until the input queues have no more complete packets
-// 1) find the next switchpacket with the lowest timestamp across all the inputports
-// 2) look at its mac, copy it into the right ports
-//          i) if it's a broadcast: sorry, you have to make N-1 copies of it...
-//          to put into the other queues
-
-struct tspacket {
-    uint64_t timestamp;
-    switchpacket * switchpack;
-
-    bool operator<(const tspacket &o) const
-    {
-        return timestamp > o.timestamp;
-    }
-};
-
-typedef struct tspacket tspacket;
-
-
-// TODO thread safe priority queue? could do in parallel?
-std::priority_queue<tspacket> pqueue;
-
-for (int i = 0; i < NUMPORTS; i++) {
-    while (!(ports[i]->inputqueue.empty())) {
-        switchpacket * sp = ports[i]->inputqueue.front();
-        ports[i]->inputqueue.pop();
-        pqueue.push( tspacket { sp->timestamp, sp });
-    }
-}
-
-// next, put back into individual output queues
-while (!pqueue.empty()) {
-    switchpacket * tsp = pqueue.top().switchpack;
-    pqueue.pop();
-    uint16_t send_to_port = get_port_from_flit(tsp->dat[0], 0 /* junk remove arg */);
-    //printf("packet for port: %x\n", send_to_port);
-    //printf("packet timestamp: %ld\n", tsp->timestamp);
-    if (send_to_port == BROADCAST_ADJUSTED) {
+// next do the switching. every input queue is already in timestamp order,
+// so rather than funnelling all packets through one priority queue:
+// 1) in parallel over input ports, look at each packet's mac and append it to
+//    a bucket for every output port it goes to. broadcasts are not copied,
+//    they are shared between output queues and reference counted
+// 2) in parallel over output ports, k-way merge that port's buckets by
+//    timestamp into its output queue
+#pragma omp parallel for
+for (int port = 0; port < NUMPORTS; port++) {
+    BasePort * current_port = ports[port];
+    while (!(current_port->inputqueue.empty())) {
+        switchpacket * tsp = current_port->inputqueue.front();
+        current_port->inputqueue.pop();
+        uint16_t send_to_port = get_port_from_flit(tsp->dat[0], &current_port->uplink_rand_state);
+        //printf("packet for port: %x\n", send_to_port);
+        //printf("packet timestamp: %ld\n", tsp->timestamp);
+        if (send_to_port == BROADCAST_ADJUSTED) {
 #define ADDUPLINK (NUMUPLINKS > 0 ? 1 : 0)
-        // this will only send broadcasts to the first (zeroeth) uplink.
-        // on a switch receiving broadcast packet from an uplink, this should
-        // automatically prevent switch from sending the broadcast to any uplink
-        for (int i = 0; i < NUMDOWNLINKS + ADDUPLINK; i++) {
-            if (i != tsp->sender ) {
-                switchpacket * tsp2 = (switchpacket*)malloc(sizeof(switchpacket));
-                memcpy(tsp2, tsp, sizeof(switchpacket));
-                ports[i]->outputqueue.push(tsp2);
+            // this will only send broadcasts to the first (zeroeth) uplink.
+            // on a switch receiving broadcast packet from an uplink, this should
+            // automatically prevent switch from sending the broadcast to any uplink
+            tsp->refcount = 0;
+            for (int i = 0; i < NUMDOWNLINKS + ADDUPLINK; i++) {
+                if (i != tsp->sender ) {
+                    tsp->refcount++;
+                    route_buckets[i][port].push_back(tsp);
+                }
+            }
+            if (tsp->refcount == 0) {
+                free(tsp);
             }
+        } else {
+            tsp->refcount = 1;
+            route_buckets[send_to_port][port].push_back(tsp);
         }
-        free(tsp);
-    } else {
-        ports[send_to_port]->outputqueue.push(tsp);
     }
 }
 
+#pragma omp parallel for
+for (int port = 0; port < NUMPORTS; port++) {
+    merge_route_buckets(port);
+}
+
 
 // finally in parallel, flush whatever we can to the output queues based on timestamp
 
@@ -218,22 +234,27 @@ int main (int argc, char *argv[]) {
 
     if (argc < 4) {
         // if insufficient args, error out
-        fprintf(stdout, "usage: ./switch LINKLATENCY SWITCHLATENCY BANDWIDTH\n");
+        fprintf(stdout, "usage: ./switch LINKLATENCY SWITCHLATENCY BANDWIDTH [SHMEMSPIN]\n");
         fprintf(stdout, "insufficient args provided\n.");
         fprintf(stdout, "LINKLATENCY and SWITCHLATENCY should be provided in cycles.\n");
         fprintf(stdout, "BANDWIDTH should be provided in Gbps\n");
+        fprintf(stdout, "SHMEMSPIN is how many times shmem ports poll before sleeping\n");
         exit(1);
     }
 
     LINKLATENCY = atoi(argv[1]);
     switchlat = atoi(argv[2]);
     bandwidth = atoi(argv[3]);
+    if (argc > 4) {
+        shmem_spin_iters = atoi(argv[4]);
+    }
 
     simplify_frac(bandwidth, 200, &throttle_numer, &throttle_denom);
 
     fprintf(stdout, "Using link latency: %d\n", LINKLATENCY);
     fprintf(stdout, "Using switching latency: %d\n", SWITCHLATENCY);
     fprintf(stdout, "BW throttle set to %d/%d\n", throttle_numer, throttle_denom);
+    fprintf(stdout, "Shmem ports poll %d times before sleeping\n", shmem_spin_iters);
 
     if ((LINKLATENCY % 7) != 0) {
         // if invalid link latency, error out.
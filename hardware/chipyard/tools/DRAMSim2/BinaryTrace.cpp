@@ -0,0 +1,220 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+//BinaryTrace.cpp
+//
+//Class files for reading and writing binary trace files
+//
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "BinaryTrace.h"
+#include "PrintMacros.h"
+
+using namespace DRAMSim;
+using namespace std;
+
+// how far ahead of the consumer the prefetch thread faults pages in, and how
+//  often the consumer wakes it up
+#define PREFETCH_WINDOW_BYTES (64UL << 20)
+#define PREFETCH_CHUNK_BYTES (1UL << 20)
+
+BinaryTraceWriter::BinaryTraceWriter(const string &filename) :
+	numRecords(0)
+{
+	traceFile = fopen(filename.c_str(), "wb");
+	if (!traceFile)
+	{
+		return;
+	}
+	// leave room for the header, it is filled in once the record count is known
+	BinaryTraceHeader header;
+	memset(&header, 0, sizeof(header));
+	fwrite(&header, sizeof(header), 1, traceFile);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter()
+{
+	if (!traceFile)
+	{
+		return;
+	}
+	BinaryTraceHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, BINARY_TRACE_MAGIC, sizeof(BINARY_TRACE_MAGIC));
+	header.version = BINARY_TRACE_VERSION;
+	header.recordSize = sizeof(BinaryTraceRecord);
+	header.numRecords = numRecords;
+
+	fseek(traceFile, 0, SEEK_SET);
+	fwrite(&header, sizeof(header), 1, traceFile);
+	fclose(traceFile);
+}
+
+void BinaryTraceWriter::write(uint64_t addr, TransactionType transType, uint64_t clockCycle)
+{
+	BinaryTraceRecord record;
+	record.address = addr;
+	record.cycleAndType = clockCycle & ~BINARY_TRACE_WRITE_BIT;
+	if (transType == DATA_WRITE)
+	{
+		record.cycleAndType |= BINARY_TRACE_WRITE_BIT;
+	}
+	fwrite(&record, sizeof(record), 1, traceFile);
+	numRecords++;
+}
+
+bool BinaryTraceReader::isBinaryTrace(const string &filename)
+{
+	char magic[sizeof(BINARY_TRACE_MAGIC)];
+	FILE *f = fopen(filename.c_str(), "rb");
+	if (!f)
+	{
+		return false;
+	}
+	bool match = fread(magic, sizeof(magic), 1, f) == 1 &&
+		memcmp(magic, BINARY_TRACE_MAGIC, sizeof(magic)) == 0;
+	fclose(f);
+	return match;
+}
+
+BinaryTraceReader::BinaryTraceReader(const string &filename) :
+	fd(-1),
+	mappedSize(0),
+	mapped(NULL),
+	records(NULL),
+	numRecords(0),
+	nextRecord(0),
+	consumedBytes(0),
+	stopPrefetch(false)
+{
+	struct stat st;
+	fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(BinaryTraceHeader))
+	{
+		ERROR("Could not open binary trace file '"<<filename<<"'");
+		return;
+	}
+
+	mappedSize = st.st_size;
+	void *p = mmap(NULL, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+	if (p == MAP_FAILED)
+	{
+		ERROR("Could not mmap binary trace file '"<<filename<<"'");
+		return;
+	}
+	mapped = (const char *)p;
+	madvise(p, mappedSize, MADV_SEQUENTIAL);
+
+	const BinaryTraceHeader *header = (const BinaryTraceHeader *)mapped;
+	if (memcmp(header->magic, BINARY_TRACE_MAGIC, sizeof(BINARY_TRACE_MAGIC)) != 0 ||
+	        header->version != BINARY_TRACE_VERSION ||
+	        header->recordSize != sizeof(BinaryTraceRecord) ||
+	        header->numRecords > (mappedSize - sizeof(*header)) / sizeof(BinaryTraceRecord))
+	{
+		ERROR("Malformed binary trace file '"<<filename<<"'");
+		return;
+	}
+
+	numRecords = header->numRecords;
+	records = (const BinaryTraceRecord *)(mapped + sizeof(*header));
+	prefetcher = thread(&BinaryTraceReader::prefetchLoop, this);
+}
+
+BinaryTraceReader::~BinaryTraceReader()
+{
+	if (prefetcher.joinable())
+	{
+		{
+			lock_guard<mutex> guard(prefetchLock);
+			stopPrefetch = true;
+		}
+		prefetchCond.notify_one();
+		prefetcher.join();
+	}
+	if (mapped)
+	{
+		munmap((void *)mapped, mappedSize);
+	}
+	if (fd >= 0)
+	{
+		close(fd);
+	}
+}
+
+void BinaryTraceReader::prefetchLoop()
+{
+	size_t pageSize = sysconf(_SC_PAGESIZE);
+	size_t touched = 0;
+	volatile char sink = 0;
+
+	while (touched < mappedSize)
+	{
+		size_t target = min(consumedBytes.load() + PREFETCH_WINDOW_BYTES, mappedSize);
+		for (; touched < target; touched += pageSize)
+		{
+			sink += mapped[touched];
+		}
+
+		unique_lock<mutex> guard(prefetchLock);
+		prefetchCond.wait(guard, [&] {
+			return stopPrefetch || consumedBytes.load() + PREFETCH_WINDOW_BYTES > touched;
+		});
+		if (stopPrefetch)
+		{
+			break;
+		}
+	}
+	(void)sink;
+}
+
+void BinaryTraceReader::next(uint64_t &addr, TransactionType &transType, uint64_t &clockCycle)
+{
+	const BinaryTraceRecord &record = records[nextRecord++];
+	addr = record.address;
+	clockCycle = record.cycleAndType & ~BINARY_TRACE_WRITE_BIT;
+	transType = (record.cycleAndType & BINARY_TRACE_WRITE_BIT) ? DATA_WRITE : DATA_READ;
+
+	// only bother the prefetcher once per chunk consumed
+	if ((nextRecord * sizeof(BinaryTraceRecord)) % PREFETCH_CHUNK_BYTES == 0)
+	{
+		{
+			lock_guard<mutex> guard(prefetchLock);
+			consumedBytes = nextRecord * sizeof(BinaryTraceRecord);
+		}
+		prefetchCond.notify_one();
+	}
+}
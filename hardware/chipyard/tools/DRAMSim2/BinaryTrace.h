@@ -0,0 +1,119 @@
+/*********************************************************************************
+*  Copyright (c) 2010-2011, Elliott Cooper-Balis
+*                             Paul Rosenfeld
+*                             Bruce Jacob
+*                             University of Maryland 
+*                             dramninjas [at] gmail [dot] com
+*  All rights reserved.
+*  
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions are met:
+*  
+*     * Redistributions of source code must retain the above copyright notice,
+*        this list of conditions and the following disclaimer.
+*  
+*     * Redistributions in binary form must reproduce the above copyright notice,
+*        this list of conditions and the following disclaimer in the documentation
+*        and/or other materials provided with the distribution.
+*  
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+*  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+*  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+*  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+*  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+*  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+*  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************/
+
+
+
+#ifndef BINARYTRACE_H
+#define BINARYTRACE_H
+
+//BinaryTrace.h
+//
+//Header file for the binary trace format: a fixed-size header followed by
+//  fixed-size records, read back through mmap with a prefetching thread
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "Transaction.h"
+
+namespace DRAMSim
+{
+
+#define BINARY_TRACE_MAGIC "DRAMTRC"
+#define BINARY_TRACE_VERSION 1
+// the top bit of the clock cycle field marks a write
+#define BINARY_TRACE_WRITE_BIT (1ULL << 63)
+
+struct BinaryTraceHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t recordSize;
+	uint64_t numRecords;
+};
+
+struct BinaryTraceRecord
+{
+	uint64_t address;
+	uint64_t cycleAndType;
+};
+
+class BinaryTraceWriter
+{
+	FILE *traceFile;
+	uint64_t numRecords;
+public:
+	BinaryTraceWriter(const std::string &filename);
+	~BinaryTraceWriter();
+
+	bool isOpen() { return traceFile != NULL; }
+	void write(uint64_t addr, TransactionType transType, uint64_t clockCycle);
+	uint64_t getNumRecords() { return numRecords; }
+};
+
+class BinaryTraceReader
+{
+	int fd;
+	size_t mappedSize;
+	const char *mapped;
+	const BinaryTraceRecord *records;
+	uint64_t numRecords;
+	uint64_t nextRecord;
+
+	// the prefetcher faults pages in ahead of nextRecord so that the
+	//  simulation loop never blocks on the disk
+	std::thread prefetcher;
+	std::mutex prefetchLock;
+	std::condition_variable prefetchCond;
+	std::atomic<size_t> consumedBytes;
+	bool stopPrefetch;
+
+	void prefetchLoop();
+public:
+	BinaryTraceReader(const std::string &filename);
+	~BinaryTraceReader();
+
+	static bool isBinaryTrace(const std::string &filename);
+
+	bool isOpen() { return records != NULL; }
+	bool eof() { return nextRecord >= numRecords; }
+	uint64_t getNumRecords() { return numRecords; }
+	void next(uint64_t &addr, TransactionType &transType, uint64_t &clockCycle);
+};
+
+}
+
+#endif
@@ -49,6 +49,7 @@
 #include "MultiChannelMemorySystem.h"
 #include "Transaction.h"
 #include "IniReader.h"
+#include "BinaryTrace.h"
 
 
 using namespace DRAMSim;
@@ -141,8 +142,8 @@ class TransactionReceiver
 void usage()
 {
 	cout << "DRAMSim2 Usage: " << endl;
-	cout << "DRAMSim -t tracefile -s system.ini -d ini/device.ini [-c #] [-p pwd] [-q] [-S 2048] [-n] [-o OPTION_A=1234,tRC=14,tFAW=19]" <<endl;
-	cout << "\t-t, --tracefile=FILENAME \tspecify a tracefile to run  "<<endl;
+	cout << "DRAMSim -t tracefile -s system.ini -d ini/device.ini [-c #] [-p pwd] [-q] [-S 2048] [-n] [-b out.btrc] [-o OPTION_A=1234,tRC=14,tFAW=19]" <<endl;
+	cout << "\t-t, --tracefile=FILENAME \tspecify a tracefile to run (text or binary, binary traces are detected by their header)"<<endl;
 	cout << "\t-s, --systemini=FILENAME \tspecify an ini file that describes the memory system parameters  "<<endl;
 	cout << "\t-d, --deviceini=FILENAME \tspecify an ini file that describes the device-level parameters"<<endl;
 	cout << "\t-c, --numcycles=# \t\tspecify number of cycles to run the simulation for [default=30] "<<endl;
@@ -152,6 +153,7 @@ void usage()
 	cout << "\t-S, --size=# \t\t\tSize of the memory system in megabytes [default=2048M]"<<endl;
 	cout << "\t-n, --notiming \t\t\tDo not use the clock cycle information in the trace file"<<endl;
 	cout << "\t-v, --visfile \t\t\tVis output filename"<<endl;
+	cout << "\t-b, --binary=FILENAME \t\tconvert the text tracefile to the binary trace format and exit"<<endl;
 }
 #endif
 
@@ -369,6 +371,46 @@ IniReader::OverrideMap *parseParamOverrides(const string &kv_str)
 	return kv_map; 
 }
 
+/**
+ * Convert a text tracefile into the binary trace format. The binary format
+ * doesn't carry write data, which is only parsed for misc traces built without
+ * NO_STORAGE.
+ **/
+int convertTraceFile(const string &traceFileName, const string &binaryFileName, TraceType traceType)
+{
+	ifstream traceFile(traceFileName.c_str());
+	if (!traceFile.is_open())
+	{
+		cout << "== Error - Could not open trace file"<<endl;
+		exit(0);
+	}
+
+	BinaryTraceWriter writer(binaryFileName);
+	if (!writer.isOpen())
+	{
+		ERROR("== Could not open binary trace file '"<<binaryFileName<<"' for writing");
+		exit(-1);
+	}
+
+	string line;
+	uint64_t addr;
+	uint64_t clockCycle=0;
+	enum TransactionType transType;
+	while (getline(traceFile, line))
+	{
+		if (line.size() == 0)
+		{
+			continue;
+		}
+		void *data = parseTraceFileLine(line, addr, transType, clockCycle, traceType, true);
+		free(data);
+		writer.write(addr, transType, clockCycle);
+	}
+
+	DEBUG("== Wrote "<<writer.getNumRecords()<<" records to '"<<binaryFileName<<"'");
+	return 0;
+}
+
 int main(int argc, char **argv)
 {
 	int c;
@@ -378,6 +420,8 @@ int main(int argc, char **argv)
 	string deviceIniFilename;
 	string pwdString;
 	string *visFilename = NULL;
+	string binaryFilename;
+	bool binaryTrace = false;
 	unsigned megsOfMemory=2048;
 	bool useClockCycle=true;
 	
@@ -401,10 +445,11 @@ int main(int argc, char **argv)
 			{"help", no_argument, 0, 'h'},
 			{"size", required_argument, 0, 'S'},
 			{"visfile", required_argument, 0, 'v'},
+			{"binary", required_argument, 0, 'b'},
 			{0, 0, 0, 0}
 		};
 		int option_index=0; //for getopt
-		c = getopt_long (argc, argv, "t:s:c:d:o:p:S:v:qn", long_options, &option_index);
+		c = getopt_long (argc, argv, "t:s:c:d:o:p:S:v:b:qn", long_options, &option_index);
 		if (c == -1)
 		{
 			break;
@@ -458,6 +503,9 @@ int main(int argc, char **argv)
 		case 'v':
 			visFilename = new string(optarg);
 			break;
+		case 'b':
+			binaryFilename = string(optarg);
+			break;
 		case '?':
 			usage();
 			exit(-1);
@@ -465,12 +513,25 @@ int main(int argc, char **argv)
 		}
 	}
 #endif
+	//ignore the pwd argument if the argument is an absolute path
+	if (pwdString.length() > 0 && traceFileName[0] != '/')
+	{
+		traceFileName = pwdString + "/" +traceFileName;
+	}
+
 	// get the trace filename
 	string temp = traceFileName.substr(traceFileName.find_last_of("/")+1);
 
 	//get the prefix of the trace name
 	temp = temp.substr(0,temp.find_first_of("_"));
-	if (temp=="mase")
+	if (BinaryTraceReader::isBinaryTrace(traceFileName))
+	{
+		// binary traces carry their command types already decoded, so the
+		//  prefix doesn't matter
+		binaryTrace = true;
+		traceType = misc;
+	}
+	else if (temp=="mase")
 	{
 		traceType = mase;
 	}
@@ -490,7 +551,7 @@ int main(int argc, char **argv)
 
 
 	// no default value for the default model name
-	if (deviceIniFilename.length() == 0)
+	if (deviceIniFilename.length() == 0 && binaryFilename.length() == 0)
 	{
 		ERROR("Please provide a device ini file");
 		usage();
@@ -498,10 +559,14 @@ int main(int argc, char **argv)
 	}
 
 
-	//ignore the pwd argument if the argument is an absolute path
-	if (pwdString.length() > 0 && traceFileName[0] != '/')
+	if (binaryFilename.length() > 0)
 	{
-		traceFileName = pwdString + "/" +traceFileName;
+		if (binaryTrace)
+		{
+			ERROR("== Trace file '"<<traceFileName<<"' is already binary");
+			exit(-1);
+		}
+		return convertTraceFile(traceFileName, binaryFilename, traceType);
 	}
 
 	DEBUG("== Loading trace file '"<<traceFileName<<"' == ");
@@ -536,19 +601,54 @@ int main(int argc, char **argv)
 	Transaction *trans=NULL;
 	bool pendingTrans = false;
 
-	traceFile.open(traceFileName.c_str());
-
-	if (!traceFile.is_open())
+	BinaryTraceReader *binaryTraceReader = NULL;
+	if (binaryTrace)
 	{
-		cout << "== Error - Could not open trace file"<<endl;
-		exit(0);
+		binaryTraceReader = new BinaryTraceReader(traceFileName);
+		if (!binaryTraceReader->isOpen())
+		{
+			cout << "== Error - Could not open trace file"<<endl;
+			exit(0);
+		}
+	}
+	else
+	{
+		traceFile.open(traceFileName.c_str());
+
+		if (!traceFile.is_open())
+		{
+			cout << "== Error - Could not open trace file"<<endl;
+			exit(0);
+		}
 	}
 
 	for (size_t i=0;i<numCycles;i++)
 	{
 		if (!pendingTrans)
 		{
-			if (!traceFile.eof())
+			if (binaryTraceReader && !binaryTraceReader->eof())
+			{
+				binaryTraceReader->next(addr, transType, clockCycle);
+				if (!useClockCycle)
+				{
+					clockCycle = 0;
+				}
+				trans = new Transaction(transType, addr, NULL);
+				alignTransactionAddress(*trans); 
+
+				if (i>=clockCycle && (*memorySystem).addTransaction(trans))
+				{
+#ifdef RETURN_TRANSACTIONS
+					transactionReceiver.add_pending(trans, i); 
+#endif
+					trans = NULL; 
+				}
+				else
+				{
+					pendingTrans = true;
+				}
+			}
+			else if (!binaryTraceReader && !traceFile.eof())
 			{
 				getline(traceFile, line);
 
@@ -606,7 +706,14 @@ int main(int argc, char **argv)
 		(*memorySystem).update();
 	}
 
-	traceFile.close();
+	if (binaryTraceReader)
+	{
+		delete binaryTraceReader;
+	}
+	else
+	{
+		traceFile.close();
+	}
 	memorySystem->printStats(true);
 	// make valgrind happy
 	if (trans)
@@ -14,12 +14,31 @@ Analysis::Analysis(Trace* t, Seq<Edge>* es)
     Edge e = es->elems[i];
     graph->addEdge(e.src, e.dst);
   }
-  nextLoad = new InstrId* [trace->numInstrs];
-  for (int i = 0; i < trace->numInstrs; i++)
-    nextLoad[i] = new InstrId [trace->numThreads*trace->numAddrs];
+
+  // Assign columns to the (thread, address) pairs that are accessed
+  int numPairs = trace->numThreads*trace->numAddrs;
+  loadCol  = new int [numPairs];
+  storeCol = new int [numPairs];
+  for (int i = 0; i < numPairs; i++) loadCol[i] = storeCol[i] = -1;
+  numLoadCols = numStoreCols = 0;
+  for (int i = 0; i < trace->numInstrs; i++) {
+    Instr instr = trace->instrs[i];
+    int idx = instr.tid*trace->numAddrs+instr.addr;
+    if ((instr.op == LD || instr.op == RMW) && loadCol[idx] < 0)
+      loadCol[idx] = numLoadCols++;
+    if ((instr.op == ST || instr.op == RMW) && storeCol[idx] < 0)
+      storeCol[idx] = numStoreCols++;
+  }
+
+  // One contiguous block for each table
+  loadData  = new InstrId [trace->numInstrs*numLoadCols];
+  storeData = new InstrId [trace->numInstrs*numStoreCols];
+  nextLoad  = new InstrId* [trace->numInstrs];
   nextStore = new InstrId* [trace->numInstrs];
-  for (int i = 0; i < trace->numInstrs; i++)
-    nextStore[i] = new InstrId [trace->numThreads*trace->numAddrs];
+  for (int i = 0; i < trace->numInstrs; i++) {
+    nextLoad[i]  = loadData + i*numLoadCols;
+    nextStore[i] = storeData + i*numStoreCols;
+  }
 }
 
 // ==========
@@ -29,12 +48,12 @@ Analysis::Analysis(Trace* t, Seq<Edge>* es)
 Analysis::~Analysis()
 {
   delete graph;
-  for (int i = 0; i < trace->numInstrs; i++)
-    delete nextLoad[i];
+  delete [] loadData;
   delete [] nextLoad;
-  for (int i = 0; i < trace->numInstrs; i++)
-    delete nextStore[i];
+  delete [] storeData;
   delete [] nextStore;
+  delete [] loadCol;
+  delete [] storeCol;
 }
 
 // =====================================
@@ -64,28 +83,27 @@ void Analysis::propagateInstr(InstrId from, InstrId to)
   Instr instr = trace->instrs[from];
   int idx = instr.tid*trace->numAddrs+instr.addr;
   if (instr.op == LD || instr.op == RMW)
-    update(&nextLoad[to][idx], from);
+    update(&nextLoad[to][loadCol[idx]], from);
   if (instr.op == ST || instr.op == RMW)
-    update(&nextStore[to][idx], from);
+    update(&nextStore[to][storeCol[idx]], from);
 }
 
 bool Analysis::propagateNext(InstrId from, InstrId to)
 {
   bool ch = false;
-  int idxTop = trace->numThreads*trace->numAddrs;
   if (back.stack.numElems == 0) {
     // If no checkpoint has been created, do fast update
-    for (int idx = 0; idx < idxTop; idx++) {
-      ch = updateFast(&nextLoad[to][idx], nextLoad[from][idx]) || ch;
-      ch = updateFast(&nextStore[to][idx], nextStore[from][idx]) || ch;
-    }
+    for (int col = 0; col < numLoadCols; col++)
+      ch = updateFast(&nextLoad[to][col], nextLoad[from][col]) || ch;
+    for (int col = 0; col < numStoreCols; col++)
+      ch = updateFast(&nextStore[to][col], nextStore[from][col]) || ch;
   }
   else {
     // Otherwise, do a backtrackable update
-    for (int idx = 0; idx < idxTop; idx++) {
-      ch = update(&nextLoad[to][idx], nextLoad[from][idx]) || ch;
-      ch = update(&nextStore[to][idx], nextStore[from][idx]) || ch;
-    }
+    for (int col = 0; col < numLoadCols; col++)
+      ch = update(&nextLoad[to][col], nextLoad[from][col]) || ch;
+    for (int col = 0; col < numStoreCols; col++)
+      ch = update(&nextStore[to][col], nextStore[from][col]) || ch;
   }
   return ch;
 }
@@ -103,11 +121,12 @@ bool Analysis::computeNext()
   if (!ok) return false;
 
   // Initialise
-  for (int i = 0; i < trace->numInstrs; i++)
-    for (int j = 0; j < trace->numAddrs * trace->numThreads; j++) {
-      nextLoad[i][j]  = trace->numInstrs;
-      nextStore[i][j] = trace->numInstrs;
-    }
+  for (int i = 0; i < trace->numInstrs; i++) {
+    for (int col = 0; col < numLoadCols; col++)
+      nextLoad[i][col] = trace->numInstrs;
+    for (int col = 0; col < numStoreCols; col++)
+      nextStore[i][col] = trace->numInstrs;
+  }
 
   // Backward propagation
   for (int i = 0; i < nodes.numElems; i++) {
@@ -128,9 +147,9 @@ bool Analysis::existsPath(InstrId src, InstrId dst)
   Instr dstInstr = trace->instrs[dst];
   int idx = dstInstr.tid * trace->numAddrs + dstInstr.addr;
   if (dstInstr.op == ST || dstInstr.op == RMW)
-    return nextStore[src][idx] <= dst;
+    return nextStore[src][storeCol[idx]] <= dst;
   else if (dstInstr.op == LD)
-    return nextLoad[src][idx] <= dst;
+    return nextLoad[src][loadCol[idx]] <= dst;
   return false;
 }
 
@@ -140,7 +159,8 @@ void Analysis::inferFrom(InstrId src, Seq<Edge>* inferred)
   if (instr.op == ST || instr.op == RMW) {
     for (int t = 0; t < trace->numThreads; t++) {
       int idx = t*trace->numAddrs+instr.addr;
-      InstrId store = nextStore[src][idx];
+      InstrId store = storeCol[idx] < 0 ?
+        trace->numInstrs : nextStore[src][storeCol[idx]];
       if (store < trace->numInstrs) {
         Seq<InstrId>* loads = &trace->readsFromInv[src];
         for (int i = 0; i < loads->numElems; i++) {
@@ -151,7 +171,8 @@ void Analysis::inferFrom(InstrId src, Seq<Edge>* inferred)
         }
       }
 
-      InstrId load = nextLoad[src][idx];
+      InstrId load = loadCol[idx] < 0 ?
+        trace->numInstrs : nextLoad[src][loadCol[idx]];
       if (load < trace->numInstrs) {
         InstrId s = trace->readsFrom[load];
         while (s >= 0 && s == src) {
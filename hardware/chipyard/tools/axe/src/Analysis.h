@@ -26,8 +26,19 @@ class Analysis
  public:
    Trace* trace;
    Graph* graph;
+
+   // nextLoad[i][loadCol[t*numAddrs+a]] is the earliest load by thread t
+   // of address a reachable from instruction i (numInstrs if none), and
+   // likewise for nextStore. Only (thread, address) pairs that have a load
+   // (resp. store) in the trace are given a column; the others map to -1.
+   int numLoadCols;
+   int numStoreCols;
+   int* loadCol;
+   int* storeCol;
    InstrId** nextLoad;
    InstrId** nextStore;
+   InstrId* loadData;   // rows of nextLoad, one contiguous block
+   InstrId* storeData;  // rows of nextStore, one contiguous block
    Backtrack back;
 
    Analysis(Trace* trace, Seq<Edge>* edges);
@@ -1,6 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/time.h>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "Seq.h"
 #include "Parser.h"
 #include "Instr.h"
@@ -11,6 +17,107 @@
 // Top-level checker
 // =================
 
+static double now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double) tv.tv_sec + (double) tv.tv_usec / 1e6;
+}
+
+static void printResult(bool ok)
+{
+  if (ok)
+    printf("OK\n");
+  else
+    printf("NO\n");
+  fflush(stdout);
+}
+
+// Check traces one at a time
+long checkSerial(Model* model, Parser* parser, Options opts)
+{
+  long numTraces = 0;
+  Seq<Instr> instrs;
+  while (parser->parseTrace(&instrs)) {
+    printResult(check(model, &instrs, opts));
+    numTraces++;
+  }
+  return numTraces;
+}
+
+// Check traces on a pool of worker threads. The main thread parses up to
+// a window of traces ahead of the oldest unprinted result and prints
+// results in input order. Each check builds its own trace analysis, so
+// workers share nothing but the model and options.
+long checkParallel(Model* model, Parser* parser, Options opts)
+{
+  const int window = 4 * opts.numThreads;
+  std::vector<Seq<Instr>*> traces(window);
+  std::vector<int> results(window);  // -1 while a check is in progress
+  for (int i = 0; i < window; i++) traces[i] = new Seq<Instr>;
+
+  std::mutex lock;
+  std::condition_variable workReady, resultReady;
+  std::deque<long> pending;
+  bool finished = false;
+
+  auto worker = [&]() {
+    std::unique_lock<std::mutex> guard(lock);
+    for (;;) {
+      workReady.wait(guard, [&] { return finished || !pending.empty(); });
+      if (pending.empty()) return;
+      long n = pending.front();
+      pending.pop_front();
+      guard.unlock();
+      bool ok = check(model, traces[n % window], opts);
+      guard.lock();
+      results[n % window] = ok;
+      resultReady.notify_one();
+    }
+  };
+  std::vector<std::thread> workers;
+  for (int i = 0; i < opts.numThreads; i++)
+    workers.push_back(std::thread(worker));
+
+  long parsed = 0, printed = 0;
+  bool more = true;
+  for (;;) {
+    // Print whatever is ready, in order
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      while (printed < parsed && results[printed % window] >= 0)
+        printResult(results[printed++ % window]);
+    }
+
+    // Parse ahead while the window has room
+    if (more && parsed - printed < window) {
+      long slot = parsed % window;
+      more = parser->parseTrace(traces[slot]);
+      if (more) {
+        std::lock_guard<std::mutex> guard(lock);
+        results[slot] = -1;
+        pending.push_back(parsed++);
+        workReady.notify_one();
+      }
+      continue;
+    }
+    if (printed == parsed) break;
+
+    // Wait for the oldest outstanding check
+    std::unique_lock<std::mutex> guard(lock);
+    resultReady.wait(guard, [&] { return results[printed % window] >= 0; });
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    finished = true;
+  }
+  workReady.notify_all();
+  for (auto &t : workers) t.join();
+  for (int i = 0; i < window; i++) delete traces[i];
+  return parsed;
+}
+
 void axeCheck(char* modelName, char* fileName, Options opts)
 {
   // Parse model name and trace file
@@ -19,15 +126,13 @@ void axeCheck(char* modelName, char* fileName, Options opts)
   Parser parser(fileName);
 
   // Check trace(s)
-  Seq<Instr> instrs;
-  while (parser.parseTrace(&instrs)) {
-    bool ok = check(&model, &instrs, opts);
-    if (ok)
-      printf("OK\n");
-    else
-      printf("NO\n");
-    fflush(stdout);
-  }
+  double start = now();
+  long numTraces = opts.numThreads > 1 ?
+    checkParallel(&model, &parser, opts) :
+    checkSerial(&model, &parser, opts);
+  double secs = now() - start;
+  fprintf(stderr, "Checked %ld traces in %.2fs (%.1f traces/s)\n",
+          numTraces, secs, secs > 0 ? (double) numTraces / secs : 0.0);
 }
 
 // ======================
@@ -11,6 +11,7 @@ Options::Options()
 {
   globalClock      = false;
   ignoreTimestamps = false;
+  numThreads       = 1;
 }
 
 // =============
@@ -23,6 +24,8 @@ void Options::set(char* flag)
     globalClock = true;
   else if (!strcmp(flag, "-i"))
     ignoreTimestamps = true;
+  else if (!strncmp(flag, "-j", 2) && atoi(flag+2) > 0)
+    numThreads = atoi(flag+2);
   else {
     fprintf(stderr, "Unknown option: '%s'\n", flag);
     exit(EXIT_FAILURE);
@@ -36,10 +39,12 @@ void Options::set(char* flag)
 void usage()
 {
   printf("Usage:\n");
-  printf("  axe check <MODEL> <FILE> [-g] [-i]\n");
+  printf("  axe check <MODEL> <FILE> [-g] [-i] [-j<N>]\n");
   printf("  axe test  <MODEL> <FILE> <FILE> [-g] [-i]\n");
   printf("Where:\n");
   printf("  <MODEL> ::= SC|TSO|PSO|WMO|POW\n");
   printf("  -g          assume global clock domain\n");
   printf("  -i          ignore timestamps\n");
+  printf("  -j<N>       check up to N traces concurrently, parsing ahead\n");
+  printf("              (not for interactive use: output lags input)\n");
 }
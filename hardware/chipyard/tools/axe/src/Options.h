@@ -8,6 +8,7 @@ void usage();
 struct Options {
   bool globalClock;
   bool ignoreTimestamps;
+  int numThreads;
 
   // Constructor
   Options();
@@ -1,6 +1,6 @@
 #!/bin/bash
 
-g++ -O2 -Wconversion -std=c++0x -I . -o axe \
+g++ -O2 -Wconversion -std=c++0x -pthread -I . -o axe \
   Main.cpp       \
   Instr.cpp      \
   Parser.cpp     \
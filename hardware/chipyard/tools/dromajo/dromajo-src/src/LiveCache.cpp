@@ -50,28 +50,37 @@
 // POSSIBILITY OF SUCH DAMAGE.
 
 
-#include "LiveCacheCore.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
 
-//#define MTRACE(a...)   do{ fprintf(stderr,"@%lld %s %d 0x%x:",(long long int)globalClock,getName(), (int)mreq->getID(), (unsigned
-// int)mreq->getAddr()); fprintf(stderr,##a); fprintf(stderr,"\n"); }while(0)
-#define MTRACE(a...)
+#include "LiveCache.h"
 
-LiveCache::LiveCache(const std::string &_name, int size)
+LiveCache::LiveCache(const std::string &_name, uint64_t size, uint32_t _assoc)
  :name(_name) {
 
-  cacheBank    = CacheType::create(size, 16, 64, "LRU", false);
-  lineSize     = cacheBank->getLineSize();
-  lineSizeBits = log2i(lineSize);
+  lineSize     = 64;
+  lineSizeBits = 6;
+  assoc        = _assoc;
+  numSets      = size / lineSize / assoc;
+  lineCount    = numSets * assoc;
+
+  assert(numSets > 0 && lineCount * lineSize == size);
+
+  tags   = (uint64_t *)malloc(sizeof(uint64_t) * lineCount);
+  stamps = (uint64_t *)calloc(lineCount, sizeof(uint64_t));
+  assert(tags && stamps);
+  for(uint64_t i = 0; i < lineCount; i++)
+    tags[i] = INVALID_TAG;
 
   nReadHit   = 0;
   nReadMiss  = 0;
   nWriteHit  = 0;
   nWriteMiss = 0;
 
-  assert(getLineSize() < 4096); // To avoid bank selection conflict (insane LiveCache line)
-
-  lineCount = (uint64_t)cacheBank->getNumLines();
   maxOrder  = 0;
+  lastTag   = INVALID_TAG;
+  lastStamp = 0;
 }
 
 LiveCache::~LiveCache() {
@@ -92,109 +101,78 @@ LiveCache::~LiveCache() {
       ,100.0*((double)nWriteMiss)/(nWriteHit+nWriteMiss)
       );
 
-  cacheBank->destroy();
+  free(tags);
+  free(stamps);
 }
 
-void LiveCache::read(uint64_t addr) {
-  Line *l = cacheBank->findLine(addr);
-  if(l) {
-    l->order = maxOrder++;
-    nReadHit++;
-    return;
+// Returns whether addr hit, and makes its line the most recently used one
+bool LiveCache::access(uint64_t addr, bool isWrite) {
+  uint64_t  tag   = addr >> lineSizeBits;
+  if(tag == lastTag) {
+    *lastStamp |= isWrite;
+    return true;
   }
-  nReadMiss++;
-
-  l = cacheBank->fillLine(addr);
-  l->st = false;
-  l->order = maxOrder++;
-}
 
-void LiveCache::write(uint64_t addr) {
-  Line *l = cacheBank->findLine(addr);
-  if(l) {
-    l->order = maxOrder++;
-    l->st    = true;
-
-    nWriteHit++;
-    return;
+  uint64_t  base  = calcSet(tag) * assoc;
+  uint64_t *t     = &tags[base];
+  uint64_t *st    = &stamps[base];
+  uint64_t  stamp = ++maxOrder << 1;
+
+  for(uint32_t i = 0; i < assoc; i++) {
+    if(t[i] == tag) {
+      // Move the line to way 0, where the next access to this set most
+      // likely finds it again; the stamps alone define the LRU order
+      uint64_t written = st[i] & 1;
+      t[i]      = t[0];
+      st[i]     = st[0];
+      t[0]      = tag;
+      st[0]     = stamp | written | isWrite;
+      lastTag   = tag;
+      lastStamp = &st[0];
+      return true;
+    }
   }
-  nWriteMiss++;
 
-  l = cacheBank->fillLine(addr);
-  l->st = true;
-  l->order = maxOrder++;
+  // Fill an invalid way (stamp 0) or else replace the least recently used
+  uint32_t victim = 0;
+  for(uint32_t i = 1; i < assoc; i++) {
+    if(st[i] < st[victim])
+      victim = i;
+  }
+  t[victim]  = tag;
+  st[victim] = stamp | isWrite;
+  lastTag    = tag;
+  lastStamp  = &st[victim];
+  return false;
 }
 
 uint64_t *LiveCache::traverse(int &n_entries) {
-  // Creating an array of cache lines
-  Line *   arr[lineCount];
-  uint64_t cnt = 0;
+  std::vector<std::pair<uint64_t, uint64_t> > lines; // (stamp, tag)
   for(uint64_t i = 0; i < lineCount; i++) {
-    if(cacheBank->getPLine(i) && cacheBank->getPLine(i)->order) {
-      arr[cnt] = cacheBank->getPLine(i);
-      cnt++;
-    }
-  }
-  mergeSort(arr, cnt);
-
-  uint64_t *addrs = (uint64_t *)malloc(sizeof(uint64_t)*cnt);
-
-  // creating loads and stores arrays
-  uint64_t in = 0;
-  for(uint64_t i = 0; i < cnt; i++) {
-    if(!arr[i]->getTag())
-      continue;
-    if (arr[i]->st) {
-      addrs[in] = 1 | (uint64_t)cacheBank->calcAddr4Tag(arr[i]->getTag());
-    }else{
-      addrs[in] = (uint64_t)cacheBank->calcAddr4Tag(arr[i]->getTag());
-      assert((addrs[in]&1)==0);
-    }
-    in++;
+    if(stamps[i])
+      lines.push_back(std::make_pair(stamps[i], tags[i]));
   }
+  std::sort(lines.begin(), lines.end());
 
-  n_entries = in;
+  uint64_t *addrs = (uint64_t *)malloc(sizeof(uint64_t) * (lines.size() + 1));
+  for(size_t i = 0; i < lines.size(); i++)
+    addrs[i] = (lines[i].second << lineSizeBits) | (lines[i].first & 1);
+
+  n_entries = lines.size();
 
   return addrs;
 }
 
-void LiveCache::mergeSort(Line **arr, uint64_t len) {
-  // in case we had one element
-  if(len < 2)
-    return;
-
-  // in case we had two elements
-  if(len == 2) {
-    if(arr[0]->order > arr[1]->order) {
-      // swap
-      Line *t = arr[0];
-      arr[0]  = arr[1];
-      arr[1]  = t;
-    }
-    return;
-  }
+bool LiveCache::saveWarmup(const char *file) {
+  FILE *f = fopen(file, "w");
+  if(!f)
+    return false;
 
-  // divide and conquer
-  uint64_t mid = (uint64_t)(len / 2);
-  Line *   arr1[mid];
-  Line *   arr2[len - mid];
-  for(uint64_t i = 0; i < mid; i++)
-    arr1[i] = arr[i];
-  for(uint64_t i = 0; i < len - mid; i++)
-    arr2[i] = arr[mid + i];
-  mergeSort(arr1, mid);
-  mergeSort(arr2, len - mid);
-
-  // merging
-  uint64_t m = 0;
-  uint64_t n = 0;
-  for(uint64_t i = 0; i < len; i++) {
-    if(n >= (len - mid) || (m < mid && arr1[m]->order <= arr2[n]->order)) {
-      arr[i] = arr1[m];
-      m++;
-    } else {
-      arr[i] = arr2[n];
-      n++;
-    }
-  }
+  int       n_entries;
+  uint64_t *addrs = traverse(n_entries);
+  for(int i = 0; i < n_entries; i++)
+    fprintf(f, "%llx\n", (unsigned long long)addrs[i]);
+  free(addrs);
+
+  return fclose(f) == 0;
 }
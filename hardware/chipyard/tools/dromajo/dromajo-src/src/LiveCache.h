@@ -54,7 +54,6 @@
 
 #include <stdint.h>
 #include <assert.h>
-#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -63,74 +62,76 @@
 
 #include <string>
 
+// LRU model of the last-level cache contents, tracked on every memory access
+// so that checkpoints can start with warm caches.
+//
+// Each set keeps the tags of its ways in one contiguous array and their LRU
+// stamps in another, so a hit only scans the set's tags and updates one
+// stamp, and only a miss searches the stamps for the oldest way. Sets are
+// selected by a hash of the line address, which spreads power-of-two strides
+// and allows any size that is a multiple of lineSize * assoc.
 class LiveCache {
 protected:
-  class CState : public StateGeneric<uint64_t> {
-  private:
-    enum StateType { M, E, S, I };
-    StateType state;
-
-  public:
-    bool     st;
-    uint64_t order;
-
-    CState() {
-      state = I;
-      clearTag();
-    }
-
-    bool isModified() const {
-      return state == M;
-    }
-    void setModified() {
-      state = M;
-    }
-    bool isValid() const {
-      return state != I;
-    }
-    bool isInvalid() const {
-      return state == I;
-    }
-
-    StateType getState() const {
-      return state;
-    };
-
-    void invalidate() {
-      state = I;
-    }
-  };
-
-  typedef CacheGeneric<CState, uint64_t>            CacheType;
-  typedef CacheGeneric<CState, uint64_t>::CacheLine Line;
-
   const std::string name;
 
-  CacheType *cacheBank;
-
   int32_t  lineSize;
   int32_t  lineSizeBits;
+  uint32_t assoc;
+  uint64_t numSets;
   uint64_t lineCount;
+
+  // [numSets][assoc]; a line address (addr >> lineSizeBits) or INVALID_TAG
+  uint64_t *tags;
+  // [numSets][assoc]; 0 if invalid, else (access number << 1) | written
+  uint64_t *stamps;
   uint64_t maxOrder;
+  // The most recently used line, which most accesses (e.g. consecutive
+  // fetches) hit again. Its stamp is already the newest, so only the written
+  // bit may need updating.
+  uint64_t  lastTag;
+  uint64_t *lastStamp;
 
   long long  nReadHit;
   long long  nReadMiss;
   long long  nWriteHit;
   long long  nWriteMiss;
 
-  void mergeSort(Line **arr, uint64_t len);
+  static const uint64_t INVALID_TAG = ~0ULL;
+
+  uint64_t calcSet(uint64_t tag) const {
+    // Fibonacci hashing, then the high bits of hash * numSets as the set
+    return (uint64_t)(((unsigned __int128)(tag * 0x9E3779B97F4A7C15ULL) * numSets) >> 64);
+  }
+
+  bool access(uint64_t addr, bool isWrite);
 
 public:
-  LiveCache(const std::string &_name, int size);
+  LiveCache(const std::string &_name, uint64_t size, uint32_t _assoc = 16);
   virtual ~LiveCache();
 
   int32_t getLineSize() const {
     return lineSize;
   }
 
-  void     read(uint64_t addr);
-  void     write(uint64_t addr);
+  void read(uint64_t addr) {
+    if (access(addr, false))
+      nReadHit++;
+    else
+      nReadMiss++;
+  }
+  void write(uint64_t addr) {
+    if (access(addr, true))
+      nWriteHit++;
+    else
+      nWriteMiss++;
+  }
+
+  // Returns the addresses of all valid lines from least to most recently
+  // used, with bit 0 set for lines that were written (malloc'ed)
   uint64_t *traverse(int &n_entries);
+  // Writes traverse() as one hex address per line, the checkpoint warm-up
+  // image. Returns false if the file could not be written.
+  bool saveWarmup(const char *file);
 };
 
 #endif
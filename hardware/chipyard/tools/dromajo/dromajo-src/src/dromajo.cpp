@@ -36,7 +36,7 @@
 #include "iomem.h"
 #include "virtio.h"
 #include "riscv_machine.h"
-#include "LiveCacheCore.h"
+#include "LiveCache.h"
 
 //#define REGRESS_COSIM 1
 #ifdef REGRESS_COSIM
@@ -102,11 +102,6 @@ int main(int argc, char **argv)
 #else
     RISCVMachine *m = virt_machine_main(argc, argv);
 
-#ifdef LIVECACHE
-    //m->llc = new LiveCache("LLC", 1024*1024*32); // 32MB LLC (should be ~2x larger than real)
-    m->llc = new LiveCache("LLC", 1024*32); // Small 32KB for testing
-#endif
-
     if (!m)
         return 1;
 
@@ -130,18 +125,5 @@ int main(int argc, char **argv)
     virt_machine_end(m);
 #endif
 
-#ifdef LIVECACHE
-#if 0
-    // LiveCache Dump
-    int addr_size;
-    uint64_t *addr = m->llc->traverse(addr_size);
-
-    for (int i = 0; i < addr_size; ++i) {
-        printf("addr:%llx %s\n", (unsigned long long)addr[i], (addr[i] & 1) ? "ST" : "LD");
-    }
-#endif
-    delete m->llc;
-#endif
-
     return 0;
 }
@@ -58,6 +58,7 @@
 #include <linux/if_tun.h>
 #endif
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <signal.h>
 #include <err.h>
 
@@ -211,19 +212,49 @@ typedef enum {
 
 #define SECTOR_SIZE 512UL
 
+/*
+ * The image is mapped rather than read per request. In snapshot mode the
+ * mapping is private, so writes land in copy-on-write pages of this process
+ * only and any number of instances can share one base image (and its page
+ * cache). The sectors written are tracked so that snapshots can save them.
+ */
 typedef struct BlockDeviceFile {
-    FILE *f;
+    uint8_t *data;
+    size_t map_size;
     int64_t nb_sectors;
     BlockDeviceModeEnum mode;
-    uint8_t **sector_table;
+    uint64_t *written; /* bitmap of the sectors written (snapshot mode) */
 } BlockDeviceFile;
 
+/* a run of sectors in a .drive snapshot file, followed by their data */
+typedef struct BlockDeviceRun {
+    uint64_t sector_num;
+    uint64_t n;
+} BlockDeviceRun;
+
 static int64_t bf_get_sector_count(BlockDevice *bs)
 {
     BlockDeviceFile *bf = (BlockDeviceFile *)bs->opaque;
     return bf->nb_sectors;
 }
 
+static bool bf_in_range(BlockDeviceFile *bf, uint64_t sector_num, uint64_t n)
+{
+    return sector_num <= (uint64_t)bf->nb_sectors &&
+           n <= (uint64_t)bf->nb_sectors - sector_num;
+}
+
+static bool bf_is_written(BlockDeviceFile *bf, uint64_t sector_num)
+{
+    return (bf->written[sector_num / 64] >> (sector_num % 64)) & 1;
+}
+
+static void bf_set_written(BlockDeviceFile *bf, uint64_t sector_num, uint64_t n)
+{
+    for (; n > 0; sector_num++, n--)
+        bf->written[sector_num / 64] |= 1ULL << (sector_num % 64);
+}
+
 //#define DUMP_BLOCK_READ
 
 static int bf_read_async(BlockDevice *bs,
@@ -239,26 +270,9 @@ static int bf_read_async(BlockDevice *bs,
         fprintf(f, "%" PRId64 " %d\n", sector_num, n);
     }
 #endif
-    if (!bf->f)
+    if (!bf_in_range(bf, sector_num, n))
         return -1;
-    if (bf->mode == BF_MODE_SNAPSHOT) {
-        int i;
-        for (i = 0; i < n; i++) {
-            if (!bf->sector_table[sector_num]) {
-                fseek(bf->f, sector_num * SECTOR_SIZE, SEEK_SET);
-                size_t got = fread(buf, 1, SECTOR_SIZE, bf->f);
-                assert(got == SECTOR_SIZE);
-            } else {
-                memcpy(buf, bf->sector_table[sector_num], SECTOR_SIZE);
-            }
-            sector_num++;
-            buf += SECTOR_SIZE;
-        }
-    } else {
-        fseek(bf->f, sector_num * SECTOR_SIZE, SEEK_SET);
-        size_t got = fread(buf, 1, n * SECTOR_SIZE, bf->f);
-        assert(got == n * SECTOR_SIZE);
-    }
+    memcpy(buf, bf->data + sector_num * SECTOR_SIZE, n * SECTOR_SIZE);
     /* synchronous read */
     return 0;
 }
@@ -268,74 +282,112 @@ static int bf_write_async(BlockDevice *bs,
                           BlockDeviceCompletionFunc *cb, void *opaque)
 {
     BlockDeviceFile *bf = (BlockDeviceFile *)bs->opaque;
-    int ret;
 
-    switch (bf->mode) {
-    case BF_MODE_RO:
-        ret = -1; /* error */
-        break;
-    case BF_MODE_RW:
-        fseek(bf->f, sector_num * SECTOR_SIZE, SEEK_SET);
-        fwrite(buf, 1, n * SECTOR_SIZE, bf->f);
-        ret = 0;
-        break;
-    case BF_MODE_SNAPSHOT:
-        {
-            if ((unsigned int)(sector_num + n) > bf->nb_sectors)
-                return -1;
-            for (int i = 0; i < n; i++) {
-                if (!bf->sector_table[sector_num]) {
-                    bf->sector_table[sector_num] = (uint8_t *)malloc(SECTOR_SIZE);
-                }
-                memcpy(bf->sector_table[sector_num], buf, SECTOR_SIZE);
-                sector_num++;
-                buf += SECTOR_SIZE;
-            }
-            ret = 0;
+    if (bf->mode == BF_MODE_RO || !bf_in_range(bf, sector_num, n))
+        return -1; /* error */
+
+    memcpy(bf->data + sector_num * SECTOR_SIZE, buf, n * SECTOR_SIZE);
+    if (bf->mode == BF_MODE_SNAPSHOT)
+        bf_set_written(bf, sector_num, n);
+    return 0;
+}
+
+static int bf_save_written(BlockDevice *bs, const char *filename)
+{
+    BlockDeviceFile *bf = (BlockDeviceFile *)bs->opaque;
+    FILE *f = fopen(filename, "wb");
+    if (!f)
+        return -1;
+
+    uint64_t sector_num = 0;
+    bool ok = true;
+    while (ok && sector_num < (uint64_t)bf->nb_sectors) {
+        if (!bf_is_written(bf, sector_num)) {
+            sector_num++;
+            continue;
+        }
+        BlockDeviceRun run = { sector_num, 0 };
+        while (sector_num < (uint64_t)bf->nb_sectors && bf_is_written(bf, sector_num)) {
+            sector_num++;
+            run.n++;
         }
-        break;
-    default:
-        abort();
+        ok = fwrite(&run, sizeof run, 1, f) == 1 &&
+             fwrite(bf->data + run.sector_num * SECTOR_SIZE, SECTOR_SIZE, run.n, f) == run.n;
+    }
+
+    if (fclose(f) != 0)
+        ok = false;
+    return ok ? 0 : -1;
+}
+
+static int bf_load_written(BlockDevice *bs, const char *filename)
+{
+    BlockDeviceFile *bf = (BlockDeviceFile *)bs->opaque;
+    FILE *f = fopen(filename, "rb");
+    if (!f)
+        return errno == ENOENT ? 0 : -1; /* nothing was written */
+
+    BlockDeviceRun run;
+    bool ok = true;
+    while (ok && fread(&run, sizeof run, 1, f) == 1) {
+        ok = bf_in_range(bf, run.sector_num, run.n) &&
+             fread(bf->data + run.sector_num * SECTOR_SIZE, SECTOR_SIZE, run.n, f) == run.n;
+        if (ok)
+            bf_set_written(bf, run.sector_num, run.n);
     }
 
-    return ret;
+    if (ferror(f))
+        ok = false;
+    fclose(f);
+    return ok ? 0 : -1;
 }
 
 static BlockDevice *block_device_init(const char *filename,
                                       BlockDeviceModeEnum mode)
 {
-    const char *mode_str;
-
-    if (mode == BF_MODE_RW) {
-        mode_str = "r+b";
-    } else {
-        mode_str = "rb";
+    int fd = open(filename, mode == BF_MODE_RW ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        perror(filename);
+        exit(1);
     }
-
-    FILE *f = fopen(filename, mode_str);
-    if (!f) {
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
         perror(filename);
         exit(1);
     }
-    fseek(f, 0, SEEK_END);
-    int64_t file_size = ftello(f);
 
     BlockDevice *bs = (BlockDevice *)mallocz(sizeof *bs);
     BlockDeviceFile *bf = (BlockDeviceFile *)mallocz(sizeof *bf);
 
     bf->mode = mode;
-    bf->nb_sectors = file_size / 512;
-    bf->f = f;
-
-    if (mode == BF_MODE_SNAPSHOT) {
-        bf->sector_table = (uint8_t **)mallocz(sizeof(bf->sector_table[0]) *
-                                   bf->nb_sectors);
+    bf->nb_sectors = st.st_size / SECTOR_SIZE;
+    bf->map_size = bf->nb_sectors * SECTOR_SIZE;
+
+    if (bf->map_size > 0) {
+        int prot = mode == BF_MODE_RO ? PROT_READ : PROT_READ | PROT_WRITE;
+        /* only RW writes reach the file; snapshot pages are reserved as
+           they are written */
+        int flags = mode == BF_MODE_RW ? MAP_SHARED : MAP_PRIVATE | MAP_NORESERVE;
+        void *data = mmap(NULL, bf->map_size, prot, flags, fd, 0);
+        if (data == MAP_FAILED) {
+            perror(filename);
+            exit(1);
+        }
+        bf->data = (uint8_t *)data;
     }
+    close(fd);
 
     bs->opaque = bf;
     bs->get_sector_count = bf_get_sector_count;
     bs->read_async = bf_read_async;
     bs->write_async = bf_write_async;
+
+    if (mode == BF_MODE_SNAPSHOT) {
+        bf->written = (uint64_t *)mallocz(sizeof(bf->written[0]) *
+                                          ((bf->nb_sectors + 63) / 64));
+        bs->save_written = bf_save_written;
+        bs->load_written = bf_load_written;
+    }
     return bs;
 }
 
@@ -614,7 +666,9 @@ static void usage(const char *prog, const char *msg)
             "       --plic START:SIZE set PLIC start address and size in B (defaults to 0x%lx:0x%lx)\n"
             "       --clint START:SIZE set CLINT start address and size in B (defaults to 0x%lx:0x%lx)\n"
             "       --custom_extension add X extension to misa for all cores\n"
-            "       --clear_ids clear mvendorid, marchid, mimpid for all cores\n",
+            "       --clear_ids clear mvendorid, marchid, mimpid for all cores\n"
+            "       --live_cache_size sets the LiveCache (LLC model) size in MiB (default 32 MiB,\n"
+            "         LIVECACHE builds only); --save also writes its contents as a warm-up image\n",
             msg,
             prog,
             (long)BOOT_BASE_ADDR, (long)RAM_BASE_ADDR,
@@ -673,6 +727,7 @@ RISCVMachine *virt_machine_main(int argc, char **argv)
     uint64_t    clint_size_override      = 0;
     bool        custom_extension         = false;
     bool        clear_ids                = false;
+    long        live_cache_size          = 32;
 
     dromajo_stdout = stdout;
     dromajo_stderr = stderr;
@@ -701,6 +756,7 @@ RISCVMachine *virt_machine_main(int argc, char **argv)
             {"clint",                   required_argument, 0,  'C' }, // CFG
             {"custom_extension",              no_argument, 0,  'u' }, // CFG
             {"clear_ids",                     no_argument, 0,  'L' }, // CFG
+            {"live_cache_size",         required_argument, 0,  'S' },
             {0,                         0,                 0,  0 }
         };
 
@@ -855,6 +911,12 @@ RISCVMachine *virt_machine_main(int argc, char **argv)
             clear_ids = true;
             break;
 
+        case 'S':
+            live_cache_size = atol(optarg);
+            if (live_cache_size <= 0)
+                usage(prog, "--live_cache_size expects a size in MiB");
+            break;
+
         default:
             usage(prog, "I'm not having this argument");
         }
@@ -1026,6 +1088,13 @@ RISCVMachine *virt_machine_main(int argc, char **argv)
     if (!s)
         return NULL;
 
+#ifdef LIVECACHE
+    // Should be ~2x larger than the real LLC
+    s->llc = new LiveCache("LLC", (uint64_t)live_cache_size << 20);
+#else
+    (void)live_cache_size;
+#endif
+
     // Overwrite the value specified in the configuration file
     if (snapshot_load_name) {
         s->common.snapshot_load_name = snapshot_load_name;
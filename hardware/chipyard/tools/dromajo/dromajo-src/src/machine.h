@@ -185,6 +185,9 @@ typedef struct VirtMachine {
     CharacterDevice *console;
     /* graphics */
     FBDevice *fb_dev;
+    /* block devices */
+    BlockDevice *drive[MAX_DRIVE_DEVICE];
+    int drive_count;
 
     const char *snapshot_load_name;
     const char *snapshot_save_name;
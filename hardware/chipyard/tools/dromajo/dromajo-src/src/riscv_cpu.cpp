@@ -52,7 +52,7 @@
 #include "cutils.h"
 #include "iomem.h"
 #include "riscv_machine.h"
-#include "LiveCacheCore.h"
+#include "LiveCache.h"
 
 // NOTE: Use GET_INSN_COUNTER not mcycle because this is just to track advancement of simulation
 #define write_reg(x, val) ({s->most_recently_written_reg = (x); \
@@ -2192,6 +2192,8 @@ static void create_csr12_recovery(uint32_t *rom, uint32_t *code_pos, uint32_t cs
 }
 
 #ifdef LIVECACHE
+#define LIVECACHE_ROM_WARMUP_LINES 8
+
 static void create_read_warmup(uint32_t *rom, uint32_t *code_pos, uint32_t *data_pos, uint64_t val)
 {
     uint32_t data_off = sizeof(uint32_t) * (*data_pos - *code_pos);
@@ -2296,19 +2298,17 @@ static void create_boot_rom(RISCVCPUState *s, const char *file, const uint64_t c
     create_csr12_recovery(rom, &code_pos, 0x7b0, 0x600 | s->priv);
 
 #ifdef LIVECACHE
-    int addr_size;
-    uint64_t *addr = s->machine->llc->traverse(addr_size);
-
-    if (addr_size > ROM_SIZE / 4) {
-        fprintf(stderr, "LiveCache: truncating boot rom from %d to %d\n", addr_size, ROM_SIZE / 4);
-        addr_size = ROM_SIZE/4;
-    }
+    // The ROM only has room to touch the most recently used lines. The whole
+    // LLC contents are saved as a separate warm-up image (.llc).
+    int n_entries;
+    uint64_t *addr = s->machine->llc->traverse(n_entries);
 
-    for (int i = 0; i < addr_size; ++i) {
+    int first = n_entries > LIVECACHE_ROM_WARMUP_LINES ? n_entries - LIVECACHE_ROM_WARMUP_LINES : 0;
+    for (int i = first; i < n_entries; ++i) {
         uint64_t a = addr[i] & ~0x1ULL;
-        printf("addr:%llx %s\n", (unsigned long long)a, (addr[i] & 1) ? "ST" : "LD");
         create_read_warmup(rom, &code_pos, &data_pos, a); // treat write like reads for the moment
     }
+    free(addr);
 #endif
 
     // NOTE: mstatus & misa should be one of the first because risvemu breaks down this
@@ -2504,6 +2504,15 @@ void riscv_cpu_serialize(RISCVCPUState *s, const char *dump_name, const uint64_t
         }
     }
 
+#ifdef LIVECACHE
+    n = strlen(dump_name) + 64;
+    char *llc_name = (char *)alloca(n);
+    snprintf(llc_name, n, "%s.llc", dump_name);
+
+    if (!s->machine->llc->saveWarmup(llc_name))
+        err(-3, "while writing %s", llc_name);
+#endif
+
     if (!boot_ram || !main_ram_found) {
         fprintf(dromajo_stderr, "ERROR: could not find boot and main ram???\n");
         exit(-3);
@@ -49,6 +49,7 @@
 #include <errno.h>
 #include <unistd.h>
 #include <time.h>
+#include <err.h>
 
 #include "cutils.h"
 #include "iomem.h"
@@ -1190,6 +1191,7 @@ RISCVMachine *virt_machine_init(const VirtMachineParams *p)
         vbus->irq = &s->plic_irq[irq_num];
         blk_dev = virtio_block_init(vbus, p->tab_drive[i].block_dev);
         (void)blk_dev;
+        s->common.drive[s->common.drive_count++] = p->tab_drive[i].block_dev;
         vbus->addr += VIRTIO_SIZE;
         irq_num++;
         s->virtio_count++;
@@ -1284,6 +1286,10 @@ void virt_machine_end(RISCVMachine *s)
     if (s->mmio_addrset_size > 0)
         free(s->mmio_addrset);
 
+#ifdef LIVECACHE
+    delete s->llc;
+#endif
+
     phys_mem_map_end(s->mem_map);
     free(s);
 }
@@ -1297,6 +1303,20 @@ void virt_machine_serialize(RISCVMachine *m, const char *dump_name)
 
     assert(m->ncpus == 1); // FIXME: riscv_cpu_serialize must be patched for multicore
     riscv_cpu_serialize(s, dump_name, m->clint_base_addr);
+
+    size_t n = strlen(dump_name) + 64;
+    char *f_name = (char *)alloca(n);
+
+    for (int i = 0; i < m->common.drive_count; ++i) {
+        BlockDevice *bs = m->common.drive[i];
+        if (!bs->save_written)
+            continue;
+
+        snprintf(f_name, n, "%s.drive%d", dump_name, i);
+
+        if (bs->save_written(bs, f_name) < 0)
+            err(-3, "while writing %s", f_name);
+    }
 }
 
 void virt_machine_deserialize(RISCVMachine *m, const char *dump_name)
@@ -1305,6 +1325,20 @@ void virt_machine_deserialize(RISCVMachine *m, const char *dump_name)
 
     assert(m->ncpus == 1); // FIXME: riscv_cpu_serialize must be patched for multicore
     riscv_cpu_deserialize(s, dump_name);
+
+    size_t n = strlen(dump_name) + 64;
+    char *f_name = (char *)alloca(n);
+
+    for (int i = 0; i < m->common.drive_count; ++i) {
+        BlockDevice *bs = m->common.drive[i];
+        if (!bs->load_written)
+            continue;
+
+        snprintf(f_name, n, "%s.drive%d", dump_name, i);
+
+        if (bs->load_written(bs, f_name) < 0)
+            err(-3, "while reading %s", f_name);
+    }
 }
 
 int virt_machine_get_sleep_duration(RISCVMachine *m, int hartid, int ms_delay)
@@ -45,7 +45,7 @@
 #include "riscv_cpu.h"
 
 #ifdef LIVECACHE
-#include "LiveCacheCore.h"
+#include "LiveCache.h"
 #endif
 
 #define MAX_CPUS  8
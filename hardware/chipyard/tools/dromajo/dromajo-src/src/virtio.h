@@ -79,6 +79,11 @@ struct BlockDevice {
     int (*write_async)(BlockDevice *bs,
                        uint64_t sector_num, const uint8_t *buf, int n,
                        BlockDeviceCompletionFunc *cb, void *opaque);
+    /* optional: save the sectors written since the device was opened to a
+       snapshot file, or write them back from one. Return 0 if OK, -1 on
+       error. Loading a file that does not exist is not an error. */
+    int (*save_written)(BlockDevice *bs, const char *filename);
+    int (*load_written)(BlockDevice *bs, const char *filename);
     void *opaque;
 };
 
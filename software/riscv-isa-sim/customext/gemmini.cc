@@ -0,0 +1,1033 @@
+// Functional model of the Gemmini matrix-multiplication accelerator.
+//
+// Gemmini is driven through custom3 RoCC instructions (see gemmini.h in
+// gemmini-rocc-tests). This extension keeps the scratchpad and accumulator
+// as flat host arrays and executes every command, including the matmul and
+// conv loop unrollers, as soon as it is issued. It checks functional
+// correctness only: no timing, no ROB, no counters.
+//
+// Run with: spike --extension=gemmini <binary>
+
+#include "rocc.h"
+#include "mmu.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// These must match gemmini_params.h of the configuration being simulated
+static const int DIM = 16;
+static const int SP_ROWS = 4 * 4096;              // BANK_NUM * BANK_ROWS
+static const int ACC_ROWS = 1024;
+static const int MAX_BLOCK_LEN = 64 / (DIM * 1);  // MAX_BYTES / (DIM * sizeof(elem_t))
+static const int MAX_BLOCK_LEN_ACC = 64 / (DIM * 4);
+static const int OUTPUT_BITS = 20;                // spatialArrayOutputType
+
+typedef int8_t elem_t;
+typedef int32_t acc_t;
+
+// funct codes
+enum {
+  k_CONFIG = 0, k_MVIN2 = 1, k_MVIN = 2, k_MVOUT = 3,
+  k_COMPUTE_PRELOADED = 4, k_COMPUTE_ACCUMULATE = 5, k_PRELOAD = 6, k_FLUSH = 7,
+  k_LOOP_WS = 8, k_LOOP_WS_CONFIG_BOUNDS = 9,
+  k_LOOP_WS_CONFIG_ADDRS_AB = 10, k_LOOP_WS_CONFIG_ADDRS_DC = 11,
+  k_LOOP_WS_CONFIG_STRIDES_AB = 12, k_LOOP_WS_CONFIG_STRIDES_DC = 13,
+  k_MVIN3 = 14, k_LOOP_CONV_WS = 15,
+  k_LOOP_CONV_WS_CONFIG_1 = 16, k_LOOP_CONV_WS_CONFIG_6 = 21,
+  k_COUNTER = 126,
+};
+
+// rs1[1:0] of a k_CONFIG command
+enum { CONFIG_EX = 0, CONFIG_LD = 1, CONFIG_ST = 2, CONFIG_IM2COL = 3 };
+
+enum { NO_ACTIVATION = 0, RELU = 1, RELU6 = 2 };
+
+// Local (scratchpad/accumulator) address layout
+static const uint32_t ADDR_ACC = 1u << 31;
+static const uint32_t ADDR_ACCUMULATE = 1u << 30;
+static const uint32_t ADDR_READ_FULL = 1u << 29;
+static const uint32_t GARBAGE_ADDR = 0xFFFFFFFF;
+
+static const uint32_t SCALE_IDENTITY_BITS = 0x3F800000;  // 1.0f
+static const uint32_t ACC_SCALE_NO_CHANGE = 0xFFFFFFFF;
+
+static bool addr_is_garbage(uint32_t a) { return (a & 0xE0007FFF) == 0xE0007FFF; }
+static uint32_t addr_row(uint32_t a) { return a & 0x3FFF; }
+
+// rs1/rs2 of mvin, mvout, preload and compute: local address, cols, rows
+static uint32_t op_addr(reg_t op) { return (uint32_t)op; }
+static size_t op_cols(reg_t op) { return (op >> 32) & 0xFFFF; }
+static size_t op_rows(reg_t op) { return (op >> 48) & 0xFFFF; }
+
+static reg_t operand(uint32_t addr, size_t cols, size_t rows)
+{
+  return ((reg_t)rows << 48) | ((reg_t)cols << 32) | addr;
+}
+
+static float bits_to_float(uint32_t bits)
+{
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+static int32_t saturate(int64_t x, int bits)
+{
+  const int64_t max = (int64_t(1) << (bits - 1)) - 1;
+  const int64_t min = -(int64_t(1) << (bits - 1));
+  return x > max ? max : (x < min ? min : x);
+}
+
+// ROUND_NEAR_EVEN from gemmini_params.h, kept expression for expression:
+// its tie test is done in float, so it can round differently from
+// nearbyintf when x * scale is not exact
+static float round_near_even(float x)
+{
+  const long long i = x;
+  const long long next = x < 0 ? x - 1 : x + 1;
+  float rem = x - i;
+  rem = rem < 0 ? -rem : rem;
+  return rem < 0.5 ? i : (rem > 0.5 ? next : (i % 2 == 0 ? i : next));
+}
+
+// Multiply by a float scale, round and saturate to elem_t, as MVIN_SCALE
+// and ACC_SCALE in gemmini_params.h do
+static elem_t scale_to_elem(int32_t x, float scale)
+{
+  const float y = round_near_even((float)x * scale);
+  return y > 127 ? 127 : (y < -128 ? -128 : (elem_t)y);
+}
+
+// Rounding right shift, as ROUNDING_RIGHT_SHIFT in gemmini_params.h does
+static int64_t round_shift(int64_t x, unsigned shift)
+{
+  if (shift == 0)
+    return x;
+  if (shift >= 63)
+    return 0;
+  const int64_t half = (x >> (shift - 1)) & 1;
+  const int64_t sticky = (x & ((int64_t(1) << (shift - 1)) - 1)) != 0;
+  const int64_t odd = (x >> shift) & 1;
+  return (x >> shift) + (half & (sticky | odd));
+}
+
+static int32_t wrap_add(int32_t a, int32_t b)
+{
+  return (int32_t)((uint32_t)a + (uint32_t)b);
+}
+
+class gemmini_t : public rocc_t
+{
+ public:
+  const char* name() { return "gemmini"; }
+
+  reg_t custom3(rocc_insn_t insn, reg_t xs1, reg_t xs2)
+  {
+    switch (insn.funct)
+    {
+      case k_CONFIG: config(xs1, xs2); break;
+      case k_MVIN: mvin(0, xs1, xs2); break;
+      case k_MVIN2: mvin(1, xs1, xs2); break;
+      case k_MVIN3: mvin(2, xs1, xs2); break;
+      case k_MVOUT: mvout(xs1, xs2); break;
+      case k_PRELOAD: preload(xs1, xs2); break;
+      case k_COMPUTE_PRELOADED: compute(true, xs1, xs2); break;
+      case k_COMPUTE_ACCUMULATE: compute(false, xs1, xs2); break;
+      case k_FLUSH: break;
+      case k_LOOP_WS_CONFIG_BOUNDS:
+        loop_ws_cfg.pad_I = xs1 & 0xFFFF;
+        loop_ws_cfg.pad_J = (xs1 >> 16) & 0xFFFF;
+        loop_ws_cfg.pad_K = (xs1 >> 32) & 0xFFFF;
+        loop_ws_cfg.I = xs2 & 0xFFFF;
+        loop_ws_cfg.J = (xs2 >> 16) & 0xFFFF;
+        loop_ws_cfg.K = (xs2 >> 32) & 0xFFFF;
+        break;
+      case k_LOOP_WS_CONFIG_ADDRS_AB: loop_ws_cfg.A = xs1; loop_ws_cfg.B = xs2; break;
+      case k_LOOP_WS_CONFIG_ADDRS_DC: loop_ws_cfg.D = xs1; loop_ws_cfg.C = xs2; break;
+      case k_LOOP_WS_CONFIG_STRIDES_AB: loop_ws_cfg.A_stride = xs1; loop_ws_cfg.B_stride = xs2; break;
+      case k_LOOP_WS_CONFIG_STRIDES_DC: loop_ws_cfg.D_stride = xs1; loop_ws_cfg.C_stride = xs2; break;
+      case k_LOOP_WS: loop_ws(xs1, xs2); break;
+      case k_LOOP_CONV_WS: loop_conv_ws(xs1, xs2); break;
+      case k_COUNTER: return 0;
+      default:
+        if (insn.funct >= k_LOOP_CONV_WS_CONFIG_1 && insn.funct <= k_LOOP_CONV_WS_CONFIG_6) {
+          loop_conv_cfg[insn.funct - k_LOOP_CONV_WS_CONFIG_1][0] = xs1;
+          loop_conv_cfg[insn.funct - k_LOOP_CONV_WS_CONFIG_1][1] = xs2;
+          break;
+        }
+        illegal_instruction();
+    }
+
+    return 0;
+  }
+
+  gemmini_t() : spad(SP_ROWS * DIM), acc(ACC_ROWS * DIM)
+  {
+    reset();
+  }
+
+  void reset()
+  {
+    std::fill(spad.begin(), spad.end(), 0);
+    std::fill(acc.begin(), acc.end(), 0);
+
+    for (int i = 0; i < 3; i++) {
+      ld[i].stride = 0;
+      ld[i].scale = 1.0f;
+      ld[i].shrunk = false;
+      ld[i].block_stride = DIM;
+      ld[i].pixel_repeats = 1;
+    }
+
+    ex.ws = false;
+    ex.activation = NO_ACTIVATION;
+    ex.in_shift = 0;
+    ex.relu6_shift = 0;
+    ex.acc_scale = 1.0f;
+    ex.a_stride = 1;
+    ex.c_stride = 1;
+    ex.a_transpose = false;
+    ex.bd_transpose = false;
+
+    memset(&st, 0, sizeof(st));
+    st.acc_scale = 1.0f;
+
+    preload_bd = operand(GARBAGE_ADDR, 0, 0);
+    preload_c = operand(GARBAGE_ADDR, 0, 0);
+    memset(pe, 0, sizeof(pe));
+    memset(weights, 0, sizeof(weights));
+
+    memset(&loop_ws_cfg, 0, sizeof(loop_ws_cfg));
+    memset(loop_conv_cfg, 0, sizeof(loop_conv_cfg));
+    loop_ws_acc_start = 0;
+    loop_conv_acc_start = 0;
+  }
+
+ private:
+  std::vector<elem_t> spad;
+  std::vector<acc_t> acc;
+
+  struct load_config_t {
+    reg_t stride;
+    float scale;
+    bool shrunk;
+    unsigned block_stride;
+    unsigned pixel_repeats;
+  } ld[3];
+
+  struct execute_config_t {
+    bool ws;
+    unsigned activation;
+    unsigned in_shift;
+    unsigned relu6_shift;
+    float acc_scale;
+    unsigned a_stride;
+    unsigned c_stride;
+    bool a_transpose;
+    bool bd_transpose;
+  } ex;
+
+  struct store_config_t {
+    uint32_t stride;
+    unsigned activation;
+    float acc_scale;
+    unsigned pool_stride, pool_size, pool_out_dim;
+    unsigned porows, pocols, orows, ocols, upad, lpad;
+  } st;
+
+  // OS keeps partial sums in the PEs; WS keeps the preloaded weights there
+  reg_t preload_bd, preload_c;
+  int32_t pe[DIM][DIM];
+  int32_t weights[DIM][DIM];
+
+  struct {
+    size_t I, J, K, pad_I, pad_J, pad_K;
+    reg_t A, B, D, C;
+    reg_t A_stride, B_stride, D_stride, C_stride;
+  } loop_ws_cfg;
+  reg_t loop_conv_cfg[6][2];
+  // The loop unrollers alternate between accumulator halves, but only move
+  // on once a loop has written its output
+  uint32_t loop_ws_acc_start, loop_conv_acc_start;
+
+  mmu_t* mmu() { return p->get_mmu(); }
+
+  elem_t* sp_row(uint32_t row) { return &spad[(row % SP_ROWS) * DIM]; }
+  acc_t* acc_row(uint32_t row) { return &acc[(row % ACC_ROWS) * DIM]; }
+
+  int32_t activate(int32_t x, unsigned activation)
+  {
+    if (activation == RELU)
+      return x > 0 ? x : 0;
+    if (activation == RELU6) {
+      const int32_t max = (6 << ex.relu6_shift) > 127 ? 127 : (6 << ex.relu6_shift);
+      return x < 0 ? 0 : (x > max ? max : x);
+    }
+    return x;
+  }
+
+  void config(reg_t rs1, reg_t rs2)
+  {
+    switch (rs1 & 3)
+    {
+      case CONFIG_EX:
+        if (!((rs1 >> 7) & 1)) {
+          ex.ws = (rs1 >> 2) & 1;
+          ex.activation = (rs1 >> 3) & 3;
+          ex.a_transpose = (rs1 >> 8) & 1;
+          ex.bd_transpose = (rs1 >> 9) & 1;
+          ex.acc_scale = bits_to_float(rs1 >> 32);
+          ex.in_shift = rs2 & 0xFFFFFFFF;
+          ex.relu6_shift = (rs2 >> 32) & 0xFFFF;
+        }
+        ex.a_stride = (rs1 >> 16) & 0xFFFF;
+        ex.c_stride = (rs2 >> 48) & 0xFFFF;
+        break;
+      case CONFIG_LD: {
+        load_config_t& cfg = ld[(rs1 >> 3) & 3];
+        cfg.stride = rs2;
+        cfg.scale = bits_to_float(rs1 >> 32);
+        cfg.shrunk = (rs1 >> 2) & 1;
+        cfg.block_stride = (rs1 >> 16) & 0xFFFF;
+        cfg.pixel_repeats = (rs1 >> 8) & 0xFF;
+        if (cfg.pixel_repeats == 0)
+          cfg.pixel_repeats = 1;
+        break;
+      }
+      case CONFIG_ST:
+        st.stride = rs2 & 0xFFFFFFFF;
+        st.activation = (rs1 >> 2) & 3;
+        if ((rs2 >> 32) != ACC_SCALE_NO_CHANGE)
+          st.acc_scale = bits_to_float(rs2 >> 32);
+        st.pool_size = (rs1 >> 6) & 3;
+        st.pool_stride = (rs1 >> 4) & 3;
+        if (st.pool_stride != 0) {
+          st.pool_out_dim = (rs1 >> 24) & 0xFF;
+          st.porows = (rs1 >> 32) & 0xFF;
+          st.pocols = (rs1 >> 40) & 0xFF;
+          st.orows = (rs1 >> 48) & 0xFF;
+          st.ocols = (rs1 >> 56) & 0xFF;
+          st.upad = (rs1 >> 8) & 3;
+          st.lpad = (rs1 >> 10) & 3;
+        } else if (st.pool_size != 0) {
+          st.pool_out_dim = (rs1 >> 24) & 0xFF;
+          st.orows = (rs1 >> 48) & 0xFF;
+          st.ocols = (rs1 >> 56) & 0xFF;
+        }
+        break;
+      case CONFIG_IM2COL:
+        // The im2col unit is a performance feature; results do not change
+        break;
+    }
+  }
+
+  void mvin(int id, reg_t dram_addr, reg_t op)
+  {
+    const load_config_t& cfg = ld[id];
+    const uint32_t laddr = op_addr(op);
+    const size_t cols = op_cols(op), rows = op_rows(op);
+    if (addr_is_garbage(laddr))
+      return;
+
+    const bool to_acc = laddr & ADDR_ACC;
+    const bool accumulate = laddr & ADDR_ACCUMULATE;
+    const size_t elem_bytes = to_acc && !cfg.shrunk ? sizeof(acc_t) : sizeof(elem_t);
+    const size_t blocks = (cols + DIM - 1) / DIM;
+
+    for (size_t r = 0; r < rows; r++) {
+      const reg_t row_dram_addr = dram_addr + r * cfg.stride;
+
+      for (size_t b = 0; b < blocks; b++) {
+        const uint32_t row = addr_row(laddr) + r + b * cfg.block_stride;
+        const size_t len = cols - b * DIM < (size_t)DIM ? cols - b * DIM : DIM;
+
+        int32_t in[DIM];
+        for (size_t j = 0; j < len; j++) {
+          const reg_t a = row_dram_addr + (b * DIM + j) * elem_bytes;
+          if (dram_addr == 0)
+            in[j] = 0;
+          else if (elem_bytes == sizeof(acc_t))
+            in[j] = (int32_t)mmu()->load_uint32(a);
+          else
+            in[j] = (elem_t)mmu()->load_uint8(a);
+        }
+
+        if (to_acc) {
+          // Shrunk rows go through the same MVIN_SCALE as scratchpad rows;
+          // full-width rows would use MVIN_SCALE_ACC, the identity here
+          if (cfg.shrunk && cfg.scale != 1.0f)
+            for (size_t j = 0; j < len; j++)
+              in[j] = scale_to_elem(in[j], cfg.scale);
+          acc_t* dst = acc_row(row);
+          for (size_t j = 0; j < len; j++)
+            dst[j] = accumulate ? wrap_add(dst[j], in[j]) : in[j];
+          continue;
+        }
+
+        if (cfg.scale != 1.0f)
+          for (size_t j = 0; j < len; j++)
+            in[j] = scale_to_elem(in[j], cfg.scale);
+
+        // Pixel repeats also copy the row into the rows above it, shifted
+        // right by a row's worth of columns each time. Rows that would cross
+        // into the other half of the scratchpad are dropped.
+        const uint32_t sp_addr = row % SP_ROWS;
+        const uint32_t floor = sp_addr < SP_ROWS / 2 ? 0 : SP_ROWS / 2;
+        for (size_t pr = cfg.pixel_repeats; pr-- > 0; ) {
+          if (sp_addr < floor + pr)
+            continue;
+          elem_t* dst = sp_row(sp_addr - pr);
+          for (size_t j = 0; j < len && pr * cols + j < (size_t)DIM; j++)
+            dst[pr * cols + j] = in[j];
+        }
+      }
+    }
+  }
+
+  // A row as the store path sees it: accumulator rows are scaled, clipped
+  // and activated unless the full-width bit is set
+  void read_out_row(uint32_t laddr, uint32_t row, int32_t out[DIM])
+  {
+    if (addr_is_garbage(laddr)) {
+      memset(out, 0, DIM * sizeof(int32_t));
+    } else if (!(laddr & ADDR_ACC)) {
+      const elem_t* src = sp_row(row);
+      for (int j = 0; j < DIM; j++)
+        out[j] = src[j];
+    } else if (laddr & ADDR_READ_FULL) {
+      memcpy(out, acc_row(row), DIM * sizeof(acc_t));
+    } else {
+      const acc_t* src = acc_row(row);
+      for (int j = 0; j < DIM; j++)
+        out[j] = activate(scale_to_elem(src[j], st.acc_scale), st.activation);
+    }
+  }
+
+  void store_row(reg_t dram_addr, const int32_t* data, size_t len, bool full)
+  {
+    for (size_t j = 0; j < len; j++) {
+      if (full)
+        mmu()->store_uint32(dram_addr + j * sizeof(acc_t), data[j]);
+      else
+        mmu()->store_uint8(dram_addr + j * sizeof(elem_t), data[j]);
+    }
+  }
+
+  void mvout(reg_t dram_addr, reg_t op)
+  {
+    const uint32_t laddr = op_addr(op);
+    const size_t cols = op_cols(op), rows = op_rows(op);
+    const bool full = (laddr & ADDR_ACC) && (laddr & ADDR_READ_FULL);
+    const size_t elem_bytes = full ? sizeof(acc_t) : sizeof(elem_t);
+    const uint32_t base = addr_row(laddr);
+    int32_t data[DIM];
+
+    if (st.pool_stride != 0) {
+      // Max-pool over the orows x ocols output tile; padding reads as zero
+      const size_t len = cols < (size_t)DIM ? cols : DIM;
+      for (unsigned porow = 0; porow < st.porows; porow++) {
+        for (unsigned pocol = 0; pocol < st.pocols; pocol++) {
+          int32_t pooled[DIM] = {0};
+          for (unsigned wrow = 0; wrow < st.pool_size; wrow++) {
+            for (unsigned wcol = 0; wcol < st.pool_size; wcol++) {
+              const int orow = porow * st.pool_stride + wrow - st.upad;
+              const int ocol = pocol * st.pool_stride + wcol - st.lpad;
+              if (orow < 0 || ocol < 0 || orow >= (int)st.orows || ocol >= (int)st.ocols)
+                memset(data, 0, sizeof(data));
+              else
+                read_out_row(laddr, base + orow * st.ocols + ocol, data);
+
+              for (size_t j = 0; j < len; j++)
+                pooled[j] = (wrow == 0 && wcol == 0) || data[j] > pooled[j] ? data[j] : pooled[j];
+            }
+          }
+          store_row(dram_addr + (porow * st.pool_out_dim + pocol) * st.stride, pooled, len, full);
+        }
+      }
+      return;
+    }
+
+    if (addr_is_garbage(laddr))
+      return;
+
+    if (st.pool_size != 0) {
+      // 1-D mvout: consecutive rows scattered over an orows x ocols tile
+      const size_t len = cols < (size_t)DIM ? cols : DIM;
+      for (size_t r = 0; r < (size_t)st.orows * st.ocols; r++) {
+        const size_t porow = r / st.ocols, pocol = r % st.ocols;
+        read_out_row(laddr, base + r, data);
+        store_row(dram_addr + (porow * st.pool_out_dim + pocol) * st.stride, data, len, full);
+      }
+      return;
+    }
+
+    const size_t blocks = (cols + DIM - 1) / DIM;
+    for (size_t r = 0; r < rows; r++) {
+      for (size_t b = 0; b < blocks; b++) {
+        const size_t len = cols - b * DIM < (size_t)DIM ? cols - b * DIM : DIM;
+        read_out_row(laddr, base + b * DIM + r, data);
+        store_row(dram_addr + r * st.stride + b * DIM * elem_bytes, data, len, full);
+      }
+    }
+  }
+
+  // Reads a matmul operand into a zero-padded DIM x DIM tile. The command
+  // gives the operand's dimensions after transposition. Accumulator rows go
+  // through the same scale and activation as the execute unit's reads.
+  void read_matrix(reg_t op, bool transpose, unsigned stride, bool full_width, int32_t out[DIM][DIM])
+  {
+    memset(out, 0, DIM * DIM * sizeof(int32_t));
+
+    const uint32_t laddr = op_addr(op);
+    if (addr_is_garbage(laddr))
+      return;
+
+    size_t rows = transpose ? op_cols(op) : op_rows(op);
+    size_t cols = transpose ? op_rows(op) : op_cols(op);
+    rows = rows < (size_t)DIM ? rows : DIM;
+    cols = cols < (size_t)DIM ? cols : DIM;
+
+    for (size_t r = 0; r < rows; r++) {
+      const uint32_t row = addr_row(laddr) + r * stride;
+      int32_t data[DIM];
+      if (!(laddr & ADDR_ACC)) {
+        const elem_t* src = sp_row(row);
+        for (size_t c = 0; c < cols; c++)
+          data[c] = src[c];
+      } else if (full_width) {
+        memcpy(data, acc_row(row), cols * sizeof(acc_t));
+      } else {
+        const acc_t* src = acc_row(row);
+        for (size_t c = 0; c < cols; c++)
+          data[c] = activate(scale_to_elem(src[c], ex.acc_scale), ex.activation);
+      }
+
+      for (size_t c = 0; c < cols; c++) {
+        if (transpose)
+          out[c][r] = data[c];
+        else
+          out[r][c] = data[c];
+      }
+    }
+  }
+
+  // out += a * b; the inner loop runs over contiguous rows so the host
+  // compiler can vectorize it
+  static void matmul_tile(const int32_t a[DIM][DIM], const int32_t b[DIM][DIM], int32_t out[DIM][DIM])
+  {
+    for (int i = 0; i < DIM; i++) {
+      int32_t row[DIM] = {0};
+      for (int k = 0; k < DIM; k++) {
+        const int32_t a_ik = a[i][k];
+        if (a_ik == 0)
+          continue;
+        for (int j = 0; j < DIM; j++)
+          row[j] += a_ik * b[k][j];
+      }
+      for (int j = 0; j < DIM; j++)
+        out[i][j] = wrap_add(out[i][j], row[j]);
+    }
+  }
+
+  void preload(reg_t rs1, reg_t rs2)
+  {
+    preload_bd = rs1;
+    preload_c = rs2;
+  }
+
+  void compute(bool preloaded, reg_t rs1, reg_t rs2)
+  {
+    int32_t a[DIM][DIM];
+    int32_t result[DIM][DIM];
+    read_matrix(rs1, ex.a_transpose, ex.a_stride, false, a);
+
+    if (!ex.ws) {
+      // Output-stationary: D seeds the PEs, B streams through
+      int32_t b[DIM][DIM];
+      if (preloaded)
+        read_matrix(preload_bd, false, 1, true, pe);
+      read_matrix(rs2, ex.bd_transpose, 1, false, b);
+      matmul_tile(a, b, pe);
+
+      for (int i = 0; i < DIM; i++)
+        for (int j = 0; j < DIM; j++)
+          result[i][j] = saturate(round_shift(pe[i][j], ex.in_shift), OUTPUT_BITS);
+    } else {
+      // Weight-stationary: B is latched from the preload, D is the bias
+      if (preloaded)
+        read_matrix(preload_bd, ex.bd_transpose, 1, false, weights);
+      read_matrix(rs2, false, 1, true, result);
+      matmul_tile(a, weights, result);
+    }
+
+    write_result(result, ex.ws ? ex.c_stride : 1);
+  }
+
+  void write_result(const int32_t result[DIM][DIM], unsigned c_stride)
+  {
+    const uint32_t laddr = op_addr(preload_c);
+    if (addr_is_garbage(laddr))
+      return;
+
+    const size_t rows = op_rows(preload_c) < (size_t)DIM ? op_rows(preload_c) : DIM;
+    const size_t cols = op_cols(preload_c) < (size_t)DIM ? op_cols(preload_c) : DIM;
+
+    for (size_t i = 0; i < rows; i++) {
+      const uint32_t row = addr_row(laddr) + i * c_stride;
+      if (laddr & ADDR_ACC) {
+        acc_t* dst = acc_row(row);
+        const bool accumulate = laddr & ADDR_ACCUMULATE;
+        for (size_t j = 0; j < cols; j++)
+          dst[j] = accumulate ? wrap_add(dst[j], result[i][j]) : result[i][j];
+      } else {
+        elem_t* dst = sp_row(row);
+        for (size_t j = 0; j < cols; j++)
+          dst[j] = activate(saturate(result[i][j], 8), ex.activation);
+      }
+    }
+  }
+
+  // The loop unrollers below issue the same command sequence as the
+  // LoopMatmul and LoopConv modules, through the same entry points the
+  // host's own commands use.
+
+  void config_ld(reg_t stride, uint32_t scale_bits, bool shrunk, unsigned block_stride,
+                 unsigned pixel_repeats, unsigned id)
+  {
+    config(((reg_t)scale_bits << 32) | ((reg_t)block_stride << 16) | ((reg_t)pixel_repeats << 8) |
+           (id << 3) | (shrunk << 2) | CONFIG_LD, stride);
+  }
+
+  void loop_ws(reg_t rs1, reg_t rs2)
+  {
+    const bool ex_accumulate = rs1 & 1;
+    const bool full_C = (rs1 >> 1) & 1;
+    const bool low_D = (rs1 >> 2) & 1;
+    const bool a_transpose = rs2 & 1;
+    const bool b_transpose = (rs2 >> 1) & 1;
+
+    const size_t I = loop_ws_cfg.I, J = loop_ws_cfg.J, K = loop_ws_cfg.K;
+    const size_t pad_I = loop_ws_cfg.pad_I, pad_J = loop_ws_cfg.pad_J, pad_K = loop_ws_cfg.pad_K;
+
+    const uint32_t A_sp_addr_start = 0;
+    const uint32_t B_sp_addr_start = SP_ROWS / 2 - K * J * DIM;
+    const uint32_t C_acc_addr_start = loop_ws_acc_start;
+
+    // Move-in D
+    if (loop_ws_cfg.D != 0) {
+      const size_t max_blocks = low_D ? (J <= (size_t)MAX_BLOCK_LEN ? J : MAX_BLOCK_LEN) :
+        (J <= (size_t)MAX_BLOCK_LEN_ACC ? J : MAX_BLOCK_LEN_ACC);
+      const size_t sizeof_D = low_D ? sizeof(elem_t) : sizeof(acc_t);
+
+      for (size_t i = 0; i < I; i++) {
+        for (size_t j = 0; j < J; j += max_blocks) {
+          const size_t blocks = j + max_blocks <= J ? max_blocks : J - j;
+          const size_t cols = blocks * DIM - (j + blocks >= J ? pad_J : 0);
+          const size_t rows = DIM - (i == I - 1 ? pad_I : 0);
+          const reg_t dram_addr = loop_ws_cfg.D + (i * loop_ws_cfg.D_stride + j) * DIM * sizeof_D;
+          const uint32_t acc_addr = ADDR_ACC | (C_acc_addr_start + (i * J + j) * DIM);
+          mvin(2, dram_addr, operand(acc_addr, cols, rows));
+        }
+      }
+    }
+
+    // Move-in A
+    {
+      const size_t max_row = a_transpose ? K : I, max_col = a_transpose ? I : K;
+      const size_t row_pad = a_transpose ? pad_K : pad_I, col_pad = a_transpose ? pad_I : pad_K;
+      const size_t max_blocks = max_col <= (size_t)MAX_BLOCK_LEN ? max_col : MAX_BLOCK_LEN;
+
+      for (size_t row = 0; row < max_row; row++) {
+        for (size_t col = 0; col < max_col; col += max_blocks) {
+          const size_t blocks = col + max_blocks <= max_col ? max_blocks : max_col - col;
+          const size_t cols = blocks * DIM - (col + blocks >= max_col ? col_pad : 0);
+          const size_t rows = DIM - (row == max_row - 1 ? row_pad : 0);
+          const reg_t dram_addr = loop_ws_cfg.A + (row * loop_ws_cfg.A_stride + col) * DIM * sizeof(elem_t);
+          const uint32_t sp_addr = A_sp_addr_start + (row * max_col + col) * DIM;
+          mvin(0, dram_addr, operand(sp_addr, cols, rows));
+        }
+      }
+    }
+
+    // Move-in B
+    {
+      const size_t max_row = b_transpose ? J : K, max_col = b_transpose ? K : J;
+      const size_t row_pad = b_transpose ? pad_J : pad_K, col_pad = b_transpose ? pad_K : pad_J;
+      const size_t max_blocks = max_col <= (size_t)MAX_BLOCK_LEN ? max_col : MAX_BLOCK_LEN;
+
+      for (size_t row = 0; row < max_row; row++) {
+        for (size_t col = 0; col < max_col; col += max_blocks) {
+          const size_t blocks = col + max_blocks <= max_col ? max_blocks : max_col - col;
+          const size_t cols = blocks * DIM - (col + blocks >= max_col ? col_pad : 0);
+          const size_t rows = DIM - (row == max_row - 1 ? row_pad : 0);
+          const reg_t dram_addr = loop_ws_cfg.B + (row * loop_ws_cfg.B_stride + col) * DIM * sizeof(elem_t);
+          const uint32_t sp_addr = B_sp_addr_start + (row * max_col + col) * DIM;
+          mvin(1, dram_addr, operand(sp_addr, cols, rows));
+        }
+      }
+    }
+
+    // Compute, in k, j, i order so that each weight tile is preloaded once
+    for (size_t k = 0; k < K; k++) {
+      for (size_t j = 0; j < J; j++) {
+        for (size_t i = 0; i < I; i++) {
+          const uint32_t a_addr = A_sp_addr_start +
+            (a_transpose ? (k * I + i) : (i * K + k)) * DIM;
+          const uint32_t b_addr = B_sp_addr_start +
+            (b_transpose ? (j * K + k) : (k * J + j)) * DIM;
+          const uint32_t c_addr = ADDR_ACC | (ex_accumulate || k != 0 ? ADDR_ACCUMULATE : 0) |
+            (C_acc_addr_start + (i * J + j) * DIM);
+
+          const size_t a_cols = DIM - (k == K - 1 ? pad_K : 0);
+          const size_t a_rows = DIM - (i == I - 1 ? pad_I : 0);
+          const size_t b_cols = DIM - (j == J - 1 ? pad_J : 0);
+          const size_t b_rows = DIM - (k == K - 1 ? pad_K : 0);
+          const size_t c_cols = DIM - (j == J - 1 ? pad_J : 0);
+          const size_t c_rows = DIM - (i == I - 1 ? pad_I : 0);
+
+          preload(operand(i == 0 ? b_addr : GARBAGE_ADDR, b_cols, b_rows),
+                  operand(c_addr, c_cols, c_rows));
+          compute(i == 0, operand(a_addr, a_cols, a_rows), operand(GARBAGE_ADDR, DIM, DIM));
+        }
+      }
+    }
+
+    // Move-out C
+    if (loop_ws_cfg.C != 0) {
+      const size_t max_blocks = full_C ? 1 : (J <= (size_t)MAX_BLOCK_LEN ? J : MAX_BLOCK_LEN);
+      const size_t sizeof_C = full_C ? sizeof(acc_t) : sizeof(elem_t);
+
+      for (size_t i = 0; i < I; i++) {
+        for (size_t j = 0; j < J; j += max_blocks) {
+          const size_t blocks = j + max_blocks <= J ? max_blocks : J - j;
+          const size_t cols = blocks * DIM - (j + blocks >= J ? pad_J : 0);
+          const size_t rows = DIM - (i == I - 1 ? pad_I : 0);
+          const reg_t dram_addr = loop_ws_cfg.C + (i * loop_ws_cfg.C_stride + j) * DIM * sizeof_C;
+          const uint32_t acc_addr = ADDR_ACC | (full_C ? ADDR_READ_FULL : 0) |
+            (C_acc_addr_start + (i * J + j) * DIM);
+          mvout(dram_addr, operand(acc_addr, cols, rows));
+        }
+      }
+
+      loop_ws_acc_start = (loop_ws_acc_start + ACC_ROWS / 2) % ACC_ROWS;
+    }
+  }
+
+  void loop_conv_ws(reg_t rs1, reg_t rs2)
+  {
+    const reg_t (&cfg)[6][2] = loop_conv_cfg;
+    const int batch_size = cfg[0][0] & 0xFFFF;
+    const int in_dim = (cfg[0][0] >> 16) & 0xFFFF;
+    const int in_channels = (cfg[0][0] >> 32) & 0xFFFF;
+    const int out_channels = (cfg[0][0] >> 48) & 0xFFFF;
+    const int out_dim = cfg[0][1] & 0xFFFF;
+    const int pool_out_dim = (cfg[0][1] >> 16) & 0xFFFF;
+    const int stride = (cfg[0][1] >> 32) & 0xFFFF;
+    const int kernel_dim = (cfg[1][0] >> 48) & 0xFFFF;
+    const int pool_stride = (cfg[1][0] >> 16) & 0xFFFF;
+    const int pool_size = (cfg[1][0] >> 32) & 0xFFFF;
+    const int pochs = cfg[1][1] & 0xFFFF;
+    const int pocols = (cfg[1][1] >> 16) & 0xFFFF;
+    const int porows = (cfg[1][1] >> 32) & 0xFFFF;
+    const int batches = (cfg[1][1] >> 48) & 0xFFFF;
+    const int lpad = cfg[2][0] & 0xFFFF;
+    const int kchs = (cfg[2][0] >> 16) & 0xFFFF;
+    const int kcols = (cfg[2][0] >> 32) & 0xFFFF;
+    const int krows = (cfg[2][0] >> 48) & 0xFFFF;
+    const int plpad = cfg[2][1] & 0xFFFF;
+    const int dpad = (cfg[2][1] >> 16) & 0xFFFF;
+    const int upad = (cfg[2][1] >> 32) & 0xFFFF;
+    const int rpad = (cfg[2][1] >> 48) & 0xFFFF;
+    const int pupad = (cfg[3][0] >> 16) & 0xFFFF;
+    const int orows = (cfg[3][0] >> 48) & 0xFFFF;
+    const int ocols = cfg[3][1] & 0xFFFF;
+    const int kernel_dilation = (cfg[3][1] >> 16) & 0xFFFF;
+    const reg_t weights_addr = cfg[4][0], output = cfg[4][1];
+    const reg_t bias = cfg[5][0], input = cfg[5][1];
+
+    const bool no_bias = rs1 & 1;
+    const bool wrot180 = (rs1 >> 1) & 1;
+    const bool trans_output_1203 = (rs1 >> 2) & 1;
+    const bool trans_weight_1203 = (rs1 >> 3) & 1;
+    const bool trans_weight_0132 = (rs1 >> 4) & 1;
+    const bool trans_input_3120 = (rs1 >> 5) & 1;
+    int max_pixels_per_row = (rs1 >> 8) & 0xFF;
+    if (max_pixels_per_row == 0)
+      max_pixels_per_row = 1;
+    const bool no_pool = rs2 & 1;
+    const int downsample = (rs2 >> 1) & 1;
+    const int input_dilated = (rs2 >> 2) & 1;
+    const unsigned activation = (rs2 >> 3) & 3;
+
+    const int ochs = pochs;
+    const int dilated_krows = krows + (kernel_dilation - 1) * (krows - 1);
+    const int dilated_kcols = kcols + (kernel_dilation - 1) * (kcols - 1);
+    int irows = orows * stride + dilated_krows - 1;
+    int icols = ocols * stride + dilated_kcols - 1;
+    int irows_unpadded = irows - upad - dpad;
+    int icols_unpadded = icols - lpad - rpad;
+    const int ichs = kchs;
+
+#define UNDILATED(x) ((input_dilated) ? (((x)+1)/2) : (x))
+#define DS(x) ((x) >> (downsample))
+
+    if (input_dilated) {
+      irows_unpadded = (irows_unpadded + 1) / 2;
+      icols_unpadded = (icols_unpadded + 1) / 2;
+      irows = irows_unpadded + UNDILATED(upad) + UNDILATED(dpad);
+      icols = icols_unpadded + UNDILATED(lpad) + UNDILATED(rpad);
+    }
+
+    const int out_channels_per_bank = ochs / DIM + (ochs % DIM != 0);
+    const int in_channels_per_bank = kchs / DIM + (kchs % DIM != 0);
+    const int B_rows = trans_weight_0132 ?
+      in_channels_per_bank * kcols * krows * ochs :
+      out_channels_per_bank * kcols * krows * kchs;
+
+    const uint32_t A_sp_addr_start = 0;
+    const uint32_t B_sp_addr_start = SP_ROWS / 2 - B_rows;
+    const uint32_t D_sp_addr_start = ADDR_ACC | loop_conv_acc_start;
+    const uint32_t C_sp_addr_start = ADDR_ACC | ADDR_ACCUMULATE | loop_conv_acc_start;
+
+    // Move-in bias
+    if (bias != 0) {
+      const int max_ochs_per_mvin = ochs < MAX_BLOCK_LEN_ACC * DIM ? ochs : MAX_BLOCK_LEN_ACC * DIM;
+
+      config_ld(0, SCALE_IDENTITY_BITS, false, batches * orows * ocols, 1, 2);
+
+      for (int b = 0; b < batches; b++)
+        for (int orow = 0; orow < orows; orow++)
+          for (int ocol = 0; ocol < ocols; ocol += DIM) {
+            const int I = ocols - ocol > DIM ? DIM : ocols - ocol;
+
+            for (int och = 0; och < ochs; och += max_ochs_per_mvin) {
+              const int J = ochs - och > max_ochs_per_mvin ? max_ochs_per_mvin : ochs - och;
+              const uint32_t D_sp_addr = D_sp_addr_start + (och / DIM) * batches * orows * ocols +
+                b * orows * ocols + orow * ocols + ocol;
+              const reg_t bias_dram_addr = no_bias ? 0 : bias + och * sizeof(acc_t);
+              mvin(2, bias_dram_addr, operand(D_sp_addr, J, I));
+            }
+          }
+    }
+
+    // Move-in input
+    {
+      int max_chs_per_mvin = ichs < MAX_BLOCK_LEN * DIM ? ichs : MAX_BLOCK_LEN * DIM;
+      if (trans_input_3120)
+        max_chs_per_mvin = batches < MAX_BLOCK_LEN * DIM ? batches : MAX_BLOCK_LEN * DIM;
+
+      const int dram_stride = trans_input_3120 ? batch_size * sizeof(elem_t) : in_channels * sizeof(elem_t);
+      const int spad_stride = trans_input_3120 ?
+        ichs * DS(irows) * DS(icols) :
+        batches * DS(irows) * DS(icols);
+
+      config_ld(dram_stride << downsample, SCALE_IDENTITY_BITS, false, spad_stride, max_pixels_per_row, 0);
+
+      const int b_it = trans_input_3120 ? max_chs_per_mvin : 1;
+      const int ich_it = trans_input_3120 ? 1 : max_chs_per_mvin;
+
+      for (int b = 0; b < batches; b += b_it)
+        for (int irow = -UNDILATED(upad); irow < irows_unpadded + UNDILATED(dpad); irow += 1 + downsample) {
+          const int irow_padded = irow + UNDILATED(upad);
+
+          for (int icol = -UNDILATED(lpad); icol < icols_unpadded + UNDILATED(rpad);) {
+            int I = icols_unpadded - icol > (DIM << downsample) ? (DIM << downsample) : icols_unpadded - icol;
+            if (icol < 0)
+              I = -icol > DIM ? DIM : -icol;
+            else if (icol >= icols_unpadded)
+              I = icols_unpadded + UNDILATED(rpad) - icol > DIM ? DIM : icols_unpadded + UNDILATED(rpad) - icol;
+
+            const int icol_padded = icol + UNDILATED(lpad);
+
+            for (int ich = 0; ich < ichs; ich += ich_it) {
+              int K = ichs - ich > max_chs_per_mvin ? max_chs_per_mvin : ichs - ich;
+              if (trans_input_3120)
+                K = batches - b > max_chs_per_mvin ? max_chs_per_mvin : batches - b;
+
+              uint32_t A_sp_addr = A_sp_addr_start + (ich / DIM) * batches * DS(irows) * DS(icols) +
+                b * DS(irows) * DS(icols) + DS(irow_padded) * DS(icols) + DS(icol_padded);
+              if (trans_input_3120)
+                A_sp_addr = A_sp_addr_start + (b / DIM) * ichs * DS(irows) * DS(icols) +
+                  ich * DS(irows) * DS(icols) + DS(irow_padded) * DS(icols) + DS(icol_padded);
+
+              const bool is_zeros = irow < 0 || irow >= irows_unpadded || icol < 0 || icol >= icols_unpadded;
+
+              reg_t in = input + ((b * in_dim * in_dim + irow * in_dim + icol) * in_channels + ich) * sizeof(elem_t);
+              if (is_zeros)
+                in = 0;
+              else if (trans_input_3120)
+                in = input + ((ich * in_dim * in_dim + irow * in_dim + icol) * batch_size + b) * sizeof(elem_t);
+
+              mvin(0, in, operand(A_sp_addr, K, I >> downsample));
+            }
+
+            icol += I;
+          }
+        }
+    }
+
+    // Move-in weights
+    {
+      int max_chs_per_mvin = ochs < MAX_BLOCK_LEN * DIM ? ochs : MAX_BLOCK_LEN * DIM;
+      if (trans_weight_0132)
+        max_chs_per_mvin = kchs < MAX_BLOCK_LEN * DIM ? kchs : MAX_BLOCK_LEN * DIM;
+
+      size_t dram_stride = out_channels * sizeof(elem_t);
+      if (trans_weight_1203)
+        dram_stride = kernel_dim * kernel_dim * out_channels * sizeof(elem_t);
+      else if (trans_weight_0132)
+        dram_stride = in_channels * sizeof(elem_t);
+
+      const size_t spad_block_stride = trans_weight_0132 ? krows * kcols * ochs : krows * kcols * kchs;
+
+      config_ld(dram_stride, SCALE_IDENTITY_BITS, false, spad_block_stride, 1, 1);
+
+      const int och_it = trans_weight_0132 ? DIM : max_chs_per_mvin;
+      const int kch_it = trans_weight_0132 ? max_chs_per_mvin : DIM;
+
+      for (int och = 0; och < ochs; och += och_it)
+        for (int krow = 0; krow < krows; krow++)
+          for (int kcol = 0; kcol < kcols; kcol++)
+            for (int kch = 0; kch < kchs; kch += kch_it) {
+              int K = kchs - kch > DIM ? DIM : kchs - kch;
+              int J = ochs - och > max_chs_per_mvin ? max_chs_per_mvin : ochs - och;
+              if (trans_weight_0132) {
+                K = ochs - och > DIM ? DIM : ochs - och;
+                J = kchs - kch > max_chs_per_mvin ? max_chs_per_mvin : kchs - kch;
+              }
+
+              uint32_t B_sp_addr = B_sp_addr_start + (och / DIM) * krows * kcols * kchs +
+                krow * kcols * kchs + kcol * kchs + kch;
+              if (trans_weight_0132)
+                B_sp_addr = B_sp_addr_start + (kch / DIM) * krows * kcols * ochs +
+                  krow * kcols * ochs + kcol * ochs + och;
+
+              reg_t w = weights_addr + ((krow * kernel_dim * in_channels + kcol * in_channels + kch) * out_channels + och) * sizeof(elem_t);
+              if (trans_weight_1203)
+                w = weights_addr + ((kch * kernel_dim * kernel_dim + krow * kernel_dim + kcol) * out_channels + och) * sizeof(elem_t);
+              else if (trans_weight_0132)
+                w = weights_addr + ((krow * kernel_dim * out_channels + kcol * out_channels + och) * in_channels + kch) * sizeof(elem_t);
+
+              mvin(1, w, operand(B_sp_addr, J, K));
+            }
+    }
+
+    // Compute
+    {
+      const int b_it = trans_input_3120 ? DIM : 1;
+      const int ocol_it = trans_input_3120 ? 1 : (DIM << input_dilated);
+
+      if (trans_input_3120)
+        config(((reg_t)(irows * icols) << 16) | (1 << 7) | CONFIG_EX, (reg_t)(orows * ocols) << 48);
+
+      for (int och = 0; och < ochs; och += DIM)
+        for (int krow = 0; krow < krows; krow++)
+          for (int kcol = 0; kcol < kcols; kcol += max_pixels_per_row)
+            for (int kch = 0; kch < kchs; kch += DIM) {
+              bool new_weights = true;
+
+              for (int b = 0; b < batches; b += b_it)
+                for (int orow = 0; orow < orows; orow++) {
+                  // Skip some kernel rows due to input-dilation
+                  if (input_dilated && ((krow * kernel_dilation + orow * stride - upad) % 2 != 0))
+                    continue;
+
+                  for (int ocol = 0; ocol < ocols;) {
+                    // Skip some cols dimensions due to input-dilation
+                    if (input_dilated && ((kcol + ocol * stride - lpad) % 2 != 0)) {
+                      ocol++;
+                      continue;
+                    }
+
+                    int irow = orow * stride + krow * kernel_dilation;
+                    int icol = ocol * stride + kcol * kernel_dilation;
+                    if (input_dilated) {
+                      irow = (irow + 1) / 2;
+                      icol = (icol + 1) / 2;
+                    }
+
+                    const int pixels = kcols - kcol > max_pixels_per_row ? max_pixels_per_row : kcols - kcol;
+
+                    const uint32_t C_sp_addr = C_sp_addr_start + (och / DIM) * batches * orows * ocols +
+                      b * orows * ocols + orow * ocols + ocol;
+
+                    int I = UNDILATED(ocols - ocol > (DIM << input_dilated) ? (DIM << input_dilated) : ocols - ocol);
+                    const int J = ochs - och > DIM ? DIM : ochs - och;
+                    const int K = pixels * (kchs - kch > DIM ? DIM : kchs - kch);
+                    if (trans_input_3120)
+                      I = batches - b > DIM ? DIM : batches - b;
+
+                    uint32_t A_sp_addr = A_sp_addr_start + (kch / DIM) * batches * DS(irows) * DS(icols) +
+                      b * DS(irows) * DS(icols) + DS(irow) * DS(icols) + DS(icol);
+                    if (trans_input_3120)
+                      A_sp_addr = A_sp_addr_start + (b / DIM) * kchs * DS(irows) * DS(icols) +
+                        kch * DS(irows) * DS(icols) + DS(irow) * DS(icols) + DS(icol);
+
+                    const int krow_ = wrot180 ? krows - krow - 1 : krow;
+                    const int kcol_ = wrot180 ? kcols - kcol - 1 : kcol;
+
+                    uint32_t B_sp_addr = B_sp_addr_start + (och / DIM) * krows * kcols * kchs +
+                      krow_ * kcols * kchs + kcol_ * kchs + kch;
+                    if (trans_weight_0132)
+                      B_sp_addr = B_sp_addr_start + (kch / DIM) * krows * kcols * ochs +
+                        krow_ * kcols * ochs + kcol_ * ochs + och;
+
+                    preload(operand(new_weights ? B_sp_addr : GARBAGE_ADDR, J, K), operand(C_sp_addr, J, I));
+                    compute(new_weights, operand(A_sp_addr, K, I), operand(GARBAGE_ADDR, J, I));
+
+                    ocol += ocol_it;
+                    new_weights = false;
+                  }
+                }
+            }
+    }
+
+#undef DS
+#undef UNDILATED
+
+    // Move-out output
+    if (output != 0) {
+      if (no_pool) {
+        for (int b = 0; b < batches; b++)
+          for (int orow = 0; orow < orows; orow++)
+            for (int ocol = 0; ocol < ocols; ocol += DIM) {
+              const int I = ocols - ocol > DIM ? DIM : ocols - ocol;
+
+              for (int och = 0; och < ochs; och += DIM) {
+                const int J = ochs - och > DIM ? DIM : ochs - och;
+                const uint32_t C_sp_addr = (C_sp_addr_start & ~ADDR_ACCUMULATE) +
+                  (och / DIM) * batches * orows * ocols + b * orows * ocols + orow * ocols + ocol;
+
+                reg_t out = output + ((b * out_dim * out_dim + orow * out_dim + ocol) * out_channels + och) * sizeof(elem_t);
+                if (trans_output_1203)
+                  out = output + ((orow * out_dim * batch_size + ocol * batch_size + b) * out_channels + och) * sizeof(elem_t);
+
+                mvout(out, operand(C_sp_addr, J, I));
+              }
+            }
+      } else {
+        const reg_t st_stride = out_channels * sizeof(elem_t);
+        config(((reg_t)ocols << 56) | ((reg_t)orows << 48) | ((reg_t)pocols << 40) | ((reg_t)porows << 32) |
+               ((reg_t)pool_out_dim << 24) | (plpad << 10) | (pupad << 8) | (pool_size << 6) |
+               (pool_stride << 4) | (activation << 2) | CONFIG_ST,
+               ((reg_t)ACC_SCALE_NO_CHANGE << 32) | st_stride);
+
+        for (int b = 0; b < batches; b++)
+          for (int poch = 0; poch < pochs; poch += DIM) {
+            const int channels = poch + DIM >= pochs ? pochs - poch : DIM;
+            const reg_t pout = output + ((b * pool_out_dim * pool_out_dim) * out_channels + poch) * sizeof(elem_t);
+            const uint32_t C_sp_addr = (C_sp_addr_start & ~ADDR_ACCUMULATE) +
+              (poch / DIM) * batches * orows * ocols + b * orows * ocols;
+            mvout(pout, operand(C_sp_addr, channels, 0));
+          }
+
+        config((activation << 2) | CONFIG_ST, ((reg_t)ACC_SCALE_NO_CHANGE << 32) | st_stride);
+      }
+
+      loop_conv_acc_start = (loop_conv_acc_start + ACC_ROWS / 2) % ACC_ROWS;
+    }
+  }
+};
+
+REGISTER_EXTENSION(gemmini, []() { return new gemmini_t; })
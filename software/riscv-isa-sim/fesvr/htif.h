@@ -70,6 +70,8 @@ class htif_t : public chunked_memif_t
   const std::vector<std::string>& host_args() { return hargs; }
 
   reg_t get_entry_point() { return entry; }
+  addr_t get_tohost_addr() { return tohost_addr; }
+  addr_t get_fromhost_addr() { return fromhost_addr; }
 
   // indicates that the initial program load can skip writing this address
   // range to memory, because it has already been loaded through a sideband
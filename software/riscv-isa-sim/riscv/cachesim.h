@@ -111,6 +111,11 @@ class icache_sim_t : public cache_memtracer_t
   {
     if (type == FETCH) cache->access(addr, bytes, false);
   }
+  void trace_batch(const memtrace_record_t* records, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      if (records[i].type == FETCH) cache->access(records[i].addr, records[i].bytes, false);
+  }
 };
 
 class dcache_sim_t : public cache_memtracer_t
@@ -125,6 +130,11 @@ class dcache_sim_t : public cache_memtracer_t
   {
     if (type == LOAD || type == STORE) cache->access(addr, bytes, type == STORE);
   }
+  void trace_batch(const memtrace_record_t* records, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      if (records[i].type != FETCH) cache->access(records[i].addr, records[i].bytes, records[i].type == STORE);
+  }
 };
 
 #endif
@@ -87,3 +87,18 @@ void clint_t::increment(reg_t inc)
       procs[i]->state.mip |= MIP_MTIP;
   }
 }
+
+reg_t clint_t::ticks_until_timer()
+{
+  if (real_time)
+    return 0;
+
+  reg_t ticks = 0;
+  for (size_t i = 0; i < procs.size(); i++) {
+    if (!(procs[i]->state.mie & MIP_MTIP) || mtimecmp[i] <= mtime)
+      continue;
+    if (ticks == 0 || mtimecmp[i] - mtime < ticks)
+      ticks = mtimecmp[i] - mtime;
+  }
+  return ticks;
+}
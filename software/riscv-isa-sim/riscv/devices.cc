@@ -1,4 +1,5 @@
 #include "devices.h"
+#include <iterator>
 
 void bus_t::add_device(reg_t addr, abstract_device_t* dev)
 {
@@ -8,10 +9,103 @@ void bus_t::add_device(reg_t addr, abstract_device_t* dev)
   // iteration over this sort, which it does. (python's
   // SortedDict is a good analogy)
   devices[addr] = dev;
+
+  // Rebuild the page map lazily, as devices are added one by one at startup
+  page_map_pages = 0;
+  page_map_stale = true;
+}
+
+bus_t::~bus_t()
+{
+  free(page_map);
+}
+
+void bus_t::build_page_map()
+{
+  static_assert(alignof(device_map_t::value_type) > PAGE_MAP_TAG, "devices entries must leave room for a tag");
+  page_map_stale = false;
+  free(page_map);
+  page_map = NULL;
+  page_map_pages = 0;
+  if (devices.empty())
+    return;
+
+  // Cover up to the end of the highest device; where that is unknown, its
+  // first page. Everything above is left to the devices map.
+  auto last = devices.rbegin();
+  reg_t end = last->first + 1;
+  if (auto mem = dynamic_cast<mem_t*>(last->second))
+    end = last->first + mem->size();
+  size_t pages = std::min<reg_t>((end + PAGE_MAP_OFFSET) >> PAGE_MAP_SHIFT, reg_t(PAGE_MAP_MAX_PAGES));
+
+  // calloc, so that pages no device covers cost no host memory
+  page_map = (uintptr_t*)calloc(pages, sizeof(uintptr_t));
+  if (!page_map)
+    return;
+
+  // Each device covers the addresses from its base up to the next device's,
+  // which is what find_device() resolves
+  const reg_t map_end = reg_t(pages) << PAGE_MAP_SHIFT;
+  for (auto it = devices.begin(); it != devices.end(); ++it) {
+    auto next = std::next(it);
+    reg_t lo = it->first;
+    reg_t hi = next == devices.end() ? map_end : std::min(next->first, map_end);
+    if (lo >= map_end)
+      break;
+
+    mem_t* mem = dynamic_cast<mem_t*>(it->second);
+    reg_t mem_end = mem ? lo + mem->size() : lo;
+    uintptr_t device_entry = (uintptr_t)&*it | PAGE_MAP_DEVICE;
+
+    // Past the end of a mem_t, the device resolves nothing, just like an
+    // empty page, so its pages are left as such
+    reg_t fill_end = mem ? std::min(hi, (mem_end + PAGE_MAP_OFFSET) & ~PAGE_MAP_OFFSET) : hi;
+    for (reg_t page = lo >> PAGE_MAP_SHIFT; (page << PAGE_MAP_SHIFT) < fill_end; page++) {
+      reg_t page_lo = page << PAGE_MAP_SHIFT;
+      reg_t page_hi = page_lo + PAGE_MAP_OFFSET + 1;
+      if (page_lo < lo || page_hi > hi)
+        page_map[page] = PAGE_MAP_MIXED;
+      else if (page_hi <= mem_end && !((uintptr_t)(mem->contents() + (page_lo - lo)) & PAGE_MAP_TAG))
+        page_map[page] = (uintptr_t)(mem->contents() + (page_lo - lo)) | PAGE_MAP_MEM;
+      else if (page_lo >= mem_end)
+        page_map[page] = device_entry;
+      else
+        page_map[page] = PAGE_MAP_MIXED;
+    }
+  }
+  page_map_pages = pages;
+}
+
+char* bus_t::addr_to_mem_slow(reg_t addr)
+{
+  if (page_map_stale) {
+    build_page_map();
+    return addr_to_mem(addr);
+  }
+
+  auto desc = find_device(addr);
+  if (auto mem = dynamic_cast<mem_t*>(desc.second))
+    if (addr - desc.first < mem->size())
+      return mem->contents() + (addr - desc.first);
+  return NULL;
 }
 
 bool bus_t::load(reg_t addr, size_t len, uint8_t* bytes)
 {
+  if (unlikely(page_map_stale))
+    build_page_map();
+
+  uintptr_t entry;
+  if (likely(page_lookup(addr, entry))) {
+    // mem_t is not accessed through load(); see mem_t::load
+    if ((entry & PAGE_MAP_TAG) == PAGE_MAP_MEM)
+      return false;
+    if ((entry & PAGE_MAP_TAG) == PAGE_MAP_DEVICE) {
+      auto desc = (device_map_t::value_type*)(entry & ~PAGE_MAP_TAG);
+      return desc->second->load(addr - desc->first, len, bytes);
+    }
+  }
+
   // Find the device with the base address closest to but
   // less than addr (price-is-right search)
   auto it = devices.upper_bound(addr);
@@ -29,6 +123,19 @@ bool bus_t::load(reg_t addr, size_t len, uint8_t* bytes)
 
 bool bus_t::store(reg_t addr, size_t len, const uint8_t* bytes)
 {
+  if (unlikely(page_map_stale))
+    build_page_map();
+
+  uintptr_t entry;
+  if (likely(page_lookup(addr, entry))) {
+    if ((entry & PAGE_MAP_TAG) == PAGE_MAP_MEM)
+      return false;
+    if ((entry & PAGE_MAP_TAG) == PAGE_MAP_DEVICE) {
+      auto desc = (device_map_t::value_type*)(entry & ~PAGE_MAP_TAG);
+      return desc->second->store(addr - desc->first, len, bytes);
+    }
+  }
+
   // See comments in bus_t::load
   auto it = devices.upper_bound(addr);
   if (devices.empty() || it == devices.begin()) {
@@ -20,14 +20,64 @@ class abstract_device_t {
 
 class bus_t : public abstract_device_t {
  public:
+  bus_t() : page_map(NULL), page_map_pages(0), page_map_stale(false) {}
+  bus_t(const bus_t& that) = delete;
+  ~bus_t();
+
   bool load(reg_t addr, size_t len, uint8_t* bytes);
   bool store(reg_t addr, size_t len, const uint8_t* bytes);
   void add_device(reg_t addr, abstract_device_t* dev);
 
   std::pair<reg_t, abstract_device_t*> find_device(reg_t addr);
 
+  // Returns the host address of addr if it is backed by a mem_t, else NULL
+  char* addr_to_mem(reg_t addr)
+  {
+    uintptr_t entry;
+    if (likely(page_lookup(addr, entry))) {
+      if ((entry & PAGE_MAP_TAG) == PAGE_MAP_MEM)
+        return entry ? (char*)entry + (addr & PAGE_MAP_OFFSET) : NULL;
+      if ((entry & PAGE_MAP_TAG) == PAGE_MAP_DEVICE)
+        return NULL;
+    }
+    return addr_to_mem_slow(addr);
+  }
+
  private:
-  std::map<reg_t, abstract_device_t*> devices;
+  typedef std::map<reg_t, abstract_device_t*> device_map_t;
+  device_map_t devices;
+
+  // Flat, page-granular map of the low physical address space, so that
+  // addr_to_mem() and load()/store() resolve most addresses without
+  // searching devices. Each entry describes one 4 KiB page:
+  //   PAGE_MAP_MEM:    the host address of the page, if it is all mem_t,
+  //                    or 0 if no device covers it
+  //   PAGE_MAP_DEVICE: the devices entry that covers all of the page
+  //   PAGE_MAP_MIXED:  the page is shared between devices, or is only
+  //                    partly backed by a mem_t; use the devices map
+  // Addresses above the map use the devices map too. The map is rebuilt on
+  // the first lookup after a device is added.
+  static const int PAGE_MAP_SHIFT = 12;
+  static const reg_t PAGE_MAP_OFFSET = (reg_t(1) << PAGE_MAP_SHIFT) - 1;
+  static const size_t PAGE_MAP_MAX_PAGES = size_t(1) << 24; // 64 GiB
+  static const uintptr_t PAGE_MAP_TAG = 3;
+  static const uintptr_t PAGE_MAP_MEM = 0;
+  static const uintptr_t PAGE_MAP_DEVICE = 1;
+  static const uintptr_t PAGE_MAP_MIXED = 2;
+  uintptr_t* page_map;
+  size_t page_map_pages;
+  bool page_map_stale;
+
+  bool page_lookup(reg_t addr, uintptr_t& entry)
+  {
+    reg_t page = addr >> PAGE_MAP_SHIFT;
+    if (page >= page_map_pages)
+      return false;
+    entry = page_map[page];
+    return true;
+  }
+  void build_page_map();
+  char* addr_to_mem_slow(reg_t addr);
 };
 
 class rom_device_t : public abstract_device_t {
@@ -69,6 +119,10 @@ class clint_t : public abstract_device_t {
   bool store(reg_t addr, size_t len, const uint8_t* bytes);
   size_t size() { return CLINT_SIZE; }
   void increment(reg_t inc);
+  // Ticks until mtime reaches the earliest mtimecmp among harts with the
+  // timer interrupt enabled, or 0 if there is no such timer or mtime follows
+  // the host clock
+  reg_t ticks_until_timer();
  private:
   typedef uint64_t mtime_t;
   typedef uint64_t mtimecmp_t;
@@ -227,6 +227,14 @@ void processor_t::step(size_t n)
     }
   }
 
+  if (unlikely(in_wfi)) {
+    // WFI resumes once an interrupt is pending locally, whether or not it is
+    // globally enabled, or when the hart is halted into debug mode
+    if (!state.debug_mode && waiting_for_interrupt())
+      return;
+    in_wfi = false;
+  }
+
   while (n > 0) {
     size_t instret = 0;
     reg_t pc = state.pc;
@@ -371,10 +379,18 @@ void processor_t::step(size_t n)
       // In the debug ROM this prevents us from wasting time looping, but also
       // allows us to switch to other threads only once per idle loop in case
       // there is activity.
+      //
+      // Outside the debug ROM, and unless single stepping (where WFI is a
+      // nop), the hart then stalls until an interrupt is pending. Once every
+      // hart stalls, sim_t can advance time straight to the next timer event.
       n = instret;
+      if (!state.debug_mode && state.single_step == state.STEP_NONE)
+        in_wfi = true;
     }
 
     state.minstret += instret;
     n -= instret;
   }
+
+  mmu->flush_trace();
 }
@@ -13,6 +13,13 @@ enum access_type {
   FETCH,
 };
 
+// One traced access, as buffered by the MMU between calls to trace_batch()
+struct memtrace_record_t {
+  uint64_t addr;
+  uint32_t bytes;
+  access_type type;
+};
+
 class memtracer_t
 {
  public:
@@ -21,6 +28,12 @@ class memtracer_t
 
   virtual bool interested_in_range(uint64_t begin, uint64_t end, access_type type) = 0;
   virtual void trace(uint64_t addr, size_t bytes, access_type type) = 0;
+  // Accesses are delivered in program order, in batches
+  virtual void trace_batch(const memtrace_record_t* records, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      trace(records[i].addr, records[i].bytes, records[i].type);
+  }
 };
 
 class memtracer_list_t : public memtracer_t
@@ -39,6 +52,17 @@ class memtracer_list_t : public memtracer_t
     for (std::vector<memtracer_t*>::iterator it = list.begin(); it != list.end(); ++it)
       (*it)->trace(addr, bytes, type);
   }
+  void trace_batch(const memtrace_record_t* records, size_t n)
+  {
+    // Interleave the tracers record by record, as a shared next-level cache
+    // (e.g. the L2 behind the I$ and D$) must see their misses in order
+    if (list.size() == 1) {
+      list[0]->trace_batch(records, n);
+      return;
+    }
+    for (size_t i = 0; i < n; i++)
+      trace(records[i].addr, records[i].bytes, records[i].type);
+  }
   void hook(memtracer_t* h)
   {
     list.push_back(h);
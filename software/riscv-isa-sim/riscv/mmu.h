@@ -30,6 +30,7 @@ struct icache_entry_t {
   reg_t tag;
   struct icache_entry_t* next;
   insn_fetch_t data;
+  reg_t paddr; // only valid in entries tagged with ICACHE_TRACE
 };
 
 struct tlb_entry_t {
@@ -115,6 +116,11 @@ public:
         if (proc) READ_MEM(addr, size); \
         return data; \
       } \
+      if (unlikely(tlb_load_tag[vpn % TLB_ENTRIES] == (vpn | TLB_TRACE))) { \
+        if (proc) READ_MEM(addr, size); \
+        trace_access(tlb_data[vpn % TLB_ENTRIES].target_offset + addr, size, LOAD); \
+        return from_target(*(target_endian<type##_t>*)(tlb_data[vpn % TLB_ENTRIES].host_offset + addr)); \
+      } \
       target_endian<type##_t> res; \
       load_slow_path(addr, sizeof(type##_t), (uint8_t*)&res, (xlate_flags)); \
       if (proc) READ_MEM(addr, size); \
@@ -178,6 +184,11 @@ public:
         if (proc) WRITE_MEM(addr, val, size); \
         *(target_endian<type##_t>*)(tlb_data[vpn % TLB_ENTRIES].host_offset + addr) = to_target(val); \
       } \
+      else if (unlikely(tlb_store_tag[vpn % TLB_ENTRIES] == (vpn | TLB_TRACE))) { \
+        if (proc) WRITE_MEM(addr, val, size); \
+        trace_access(tlb_data[vpn % TLB_ENTRIES].target_offset + addr, size, STORE); \
+        *(target_endian<type##_t>*)(tlb_data[vpn % TLB_ENTRIES].host_offset + addr) = to_target(val); \
+      } \
       else { \
         target_endian<type##_t> target_val = to_target(val); \
         store_slow_path(addr, sizeof(type##_t), (const uint8_t*)&target_val, (xlate_flags)); \
@@ -320,8 +331,11 @@ public:
 
     reg_t paddr = tlb_entry.target_offset + addr;;
     if (tracer.interested_in_range(paddr, paddr + 1, FETCH)) {
-      entry->tag = -1;
-      tracer.trace(paddr, length, FETCH);
+      // Keep the decoded instruction, but tag the entry so that it misses in
+      // the execute loop and each fetch from it is traced by access_icache
+      entry->tag = addr | ICACHE_TRACE;
+      entry->paddr = paddr;
+      trace_access(paddr, length, FETCH);
     }
     return entry;
   }
@@ -331,6 +345,10 @@ public:
     icache_entry_t* entry = &icache[icache_index(addr)];
     if (likely(entry->tag == addr))
       return entry;
+    if (unlikely(entry->tag == (addr | ICACHE_TRACE)) && entry->tag != reg_t(-1)) {
+      trace_access(entry->paddr, entry->data.insn.length(), FETCH);
+      return entry;
+    }
     return refill_icache(addr, entry);
   }
 
@@ -344,6 +362,14 @@ public:
   void flush_icache();
 
   void register_memtracer(memtracer_t*);
+  // Hands the buffered trace records to the tracers
+  void flush_trace()
+  {
+    if (trace_len) {
+      tracer.trace_batch(trace_buf, trace_len);
+      trace_len = 0;
+    }
+  }
 
   int is_dirty_enabled()
   {
@@ -396,17 +422,38 @@ private:
 
   // implement an instruction cache for simulator performance
   icache_entry_t icache[ICACHE_ENTRIES];
+  // Instruction addresses are at least 2-byte aligned, so the lsb of an
+  // icache tag marks entries whose fetches must be traced
+  static const reg_t ICACHE_TRACE = 1;
 
   // implement a TLB for simulator performance
   static const reg_t TLB_ENTRIES = 256;
   // If a TLB tag has TLB_CHECK_TRIGGERS set, then the MMU must check for a
   // trigger match before completing an access.
   static const reg_t TLB_CHECK_TRIGGERS = reg_t(1) << 63;
+  // If a load or store TLB tag has TLB_TRACE set, the access is to a page a
+  // memtracer is interested in, and is recorded with trace_access().
+  static const reg_t TLB_TRACE = reg_t(1) << 62;
   tlb_entry_t tlb_data[TLB_ENTRIES];
   reg_t tlb_insn_tag[TLB_ENTRIES];
   reg_t tlb_load_tag[TLB_ENTRIES];
   reg_t tlb_store_tag[TLB_ENTRIES];
 
+  // Traced accesses are buffered here, so that tracing does not keep pages
+  // out of the TLB. The buffer is handed to the tracers when it fills and at
+  // the end of every processor_t::step(), which keeps the records of
+  // different harts in the order they were simulated.
+  static const size_t TRACE_ENTRIES = 4096;
+  memtrace_record_t trace_buf[TRACE_ENTRIES];
+  size_t trace_len;
+
+  inline void trace_access(reg_t paddr, size_t bytes, access_type type)
+  {
+    trace_buf[trace_len++] = {paddr, (uint32_t)bytes, type};
+    if (unlikely(trace_len == TRACE_ENTRIES))
+      flush_trace();
+  }
+
   // finish translation on a TLB miss and update the TLB
   tlb_entry_t refill_tlb(reg_t vaddr, reg_t paddr, char* host_addr, access_type type);
   const char* fill_from_mmio(reg_t vaddr, reg_t paddr);
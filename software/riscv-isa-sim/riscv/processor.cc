@@ -460,6 +460,7 @@ void processor_t::reset()
 
   state.dcsr.halt = halt_on_reset;
   halt_on_reset = false;
+  in_wfi = false;
   set_csr(CSR_MSTATUS, state.mstatus);
   VU.reset();
 
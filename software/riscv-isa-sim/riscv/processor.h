@@ -331,6 +331,12 @@ public:
   // When true, take the slow simulation path.
   bool slow_path();
   bool halted() { return state.debug_mode; }
+  // True while stalled in WFI with no locally enabled interrupt or halt
+  // request pending, i.e. nothing on this hart will make progress until an
+  // interrupt arrives from outside
+  bool waiting_for_interrupt() {
+    return in_wfi && !(state.mip & state.mie) && halt_request == HR_NONE && !state.dcsr.halt;
+  }
   enum {
     HR_NONE,    /* Halt request is inactive. */
     HR_REGULAR, /* Regular halt request/debug interrupt. */
@@ -440,6 +446,7 @@ private:
   bool log_commits_enabled;
   FILE *log_file;
   bool halt_on_reset;
+  bool in_wfi;
   std::vector<bool> extension_table;
   std::vector<bool> impl_table;
   
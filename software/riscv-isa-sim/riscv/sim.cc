@@ -49,6 +49,8 @@ sim_t::sim_t(const char* isa, const char* priv, const char* varch,
     log_file(log_path),
     current_step(0),
     current_proc(0),
+    slices_since_host(0),
+    htif_written(false),
     debug(false),
     histogram_enabled(false),
     log(false),
@@ -200,14 +202,41 @@ void sim_t::step(size_t n)
       procs[current_proc]->get_mmu()->yield_load_reservation();
       if (++current_proc == procs.size()) {
         current_proc = 0;
-        clint->increment(INTERLEAVE / INSNS_PER_RTC_TICK);
+        clint->increment(INTERLEAVE / INSNS_PER_RTC_TICK * idle_rounds());
       }
 
-      host->switch_to();
+      // The host only has work to do once the target writes tohost (or clears
+      // fromhost to receive the next message); otherwise it just polls
+      // devices such as the console, which it can do less often.
+      if (htif_written || ++slices_since_host == HOST_POLL_SLICES) {
+        host->switch_to();
+        htif_written = false;
+        slices_since_host = 0;
+      }
     }
   }
 }
 
+// Number of rounds of RTC ticks to advance at the end of a round. Once every
+// hart is stalled in WFI, only the CLINT timer can wake them without outside
+// help, so the rounds until the earliest enabled mtimecmp are skipped in one
+// go: the interrupt fires at the same mtime as when stepping round by round.
+// The debugger, which could also wake the harts, is still serviced at least
+// every MAX_IDLE_ROUNDS.
+reg_t sim_t::idle_rounds()
+{
+  for (processor_t* proc : procs)
+    if (!proc->waiting_for_interrupt())
+      return 1;
+
+  const reg_t ticks_per_round = INTERLEAVE / INSNS_PER_RTC_TICK;
+  reg_t ticks = clint->ticks_until_timer();
+  if (ticks == 0)
+    return 1;
+  reg_t rounds = ticks / ticks_per_round + (ticks % ticks_per_round != 0);
+  return rounds < MAX_IDLE_ROUNDS ? rounds : MAX_IDLE_ROUNDS;
+}
+
 void sim_t::set_debug(bool value)
 {
   debug = value;
@@ -266,6 +295,21 @@ bool sim_t::mmio_store(reg_t addr, size_t len, const uint8_t* bytes)
   return bus.store(addr, len, bytes);
 }
 
+bool sim_t::watches_page(reg_t addr)
+{
+  reg_t tohost = get_tohost_addr(), fromhost = get_fromhost_addr();
+  return (tohost && (addr >> PGSHIFT) == (tohost >> PGSHIFT)) ||
+         (fromhost && (addr >> PGSHIFT) == (fromhost >> PGSHIFT));
+}
+
+void sim_t::watched_store(reg_t addr, size_t len)
+{
+  reg_t tohost = get_tohost_addr(), fromhost = get_fromhost_addr();
+  if ((addr < tohost + 8 && addr + len > tohost) ||
+      (addr < fromhost + 8 && addr + len > fromhost))
+    htif_written = true;
+}
+
 void sim_t::make_dtb()
 {
   if (!dtb_file.empty()) {
@@ -350,11 +394,7 @@ void sim_t::set_rom()
 char* sim_t::addr_to_mem(reg_t addr) {
   if (!paddr_ok(addr))
     return NULL;
-  auto desc = bus.find_device(addr);
-  if (auto mem = dynamic_cast<mem_t*>(desc.second))
-    if (addr - desc.first < mem->size())
-      return mem->contents() + (addr - desc.first);
-  return NULL;
+  return bus.addr_to_mem(addr);
 }
 
 const char* sim_t::get_symbol(uint64_t addr)
@@ -77,11 +77,16 @@ private:
 
   processor_t* get_core(const std::string& i);
   void step(size_t n); // step through simulation
+  reg_t idle_rounds();
   static const size_t INTERLEAVE = 5000;
   static const size_t INSNS_PER_RTC_TICK = 100; // 10 MHz clock for 1 BIPS core
   static const size_t CPU_HZ = 1000000000; // 1GHz CPU
+  static const reg_t MAX_IDLE_ROUNDS = 1 << 16; // debugger poll interval while idle
+  static const size_t HOST_POLL_SLICES = 64; // host poll interval without HTIF stores
   size_t current_step;
   size_t current_proc;
+  size_t slices_since_host;
+  bool htif_written; // by the target since the host last ran
   bool debug;
   bool histogram_enabled; // provide a histogram of PCs
   bool log;
@@ -91,6 +96,8 @@ private:
   char* addr_to_mem(reg_t addr);
   bool mmio_load(reg_t addr, size_t len, uint8_t* bytes);
   bool mmio_store(reg_t addr, size_t len, const uint8_t* bytes);
+  bool watches_page(reg_t addr);
+  void watched_store(reg_t addr, size_t len);
   void make_dtb();
   void set_rom();
 
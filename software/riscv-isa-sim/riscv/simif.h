@@ -14,6 +14,10 @@ public:
   // used for MMIO addresses
   virtual bool mmio_load(reg_t addr, size_t len, uint8_t* bytes) = 0;
   virtual bool mmio_store(reg_t addr, size_t len, const uint8_t* bytes) = 0;
+  // Stores to memory pages the simulation watches never hit in the TLB, so
+  // that each one is reported through watched_store()
+  virtual bool watches_page(reg_t addr) { return false; }
+  virtual void watched_store(reg_t addr, size_t len) {}
   // Callback for processors to let the simulation know they were reset.
   virtual void proc_reset(unsigned id) = 0;
 
@@ -4,11 +4,24 @@
 //   core   0: 0x000000008000c36c (0xfe843783) ld      a5, -24(s0)
 // in its inputs, then output the RISC-V instruction with the disassembly
 // enclosed hexadecimal number.
+//
+// Commit logs can be many GB, so the input is mapped (or read in large
+// blocks when it is a pipe), split into line-aligned chunks, and the chunks
+// are scanned in parallel. Output is written in input order.
 
 #include <iostream>
 #include <string>
 #include <cstdint>
-#include <regex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "fesvr/option_parser.h"
 
 #include "disasm.h"
@@ -16,44 +29,220 @@
 
 using namespace std;
 
+static const size_t CHUNK_SIZE = 4 << 20;
+
+// Equivalent to matching a line against the regular expression
+//   ^core\s+\d+:\s+0x[0-9a-f]+\s+\(0x([0-9a-f]+)\)
+// case-insensitively and converting the group with strtoull(group, 16)
+static inline bool is_space(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+static inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+static inline int hex_value(char c)
+{
+  if (c >= '0' && c <= '9') return c - '0';
+  c |= 0x20;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+static bool scan_line(const char* p, const char* end, uint64_t* opcode)
+{
+  static const char core[] = "core";
+  for (int i = 0; i < 4; i++, p++)
+    if (p == end || (*p | 0x20) != core[i])
+      return false;
+
+  const char* start = p;
+  while (p != end && is_space(*p)) p++;
+  if (p == start) return false;
+  start = p;
+  while (p != end && is_digit(*p)) p++;
+  if (p == start || p == end || *p++ != ':') return false;
+  start = p;
+  while (p != end && is_space(*p)) p++;
+  if (p == start) return false;
+
+  if (end - p < 2 || p[0] != '0' || (p[1] | 0x20) != 'x') return false;
+  p += 2;
+  start = p;
+  while (p != end && hex_value(*p) >= 0) p++;
+  if (p == start) return false;
+  start = p;
+  while (p != end && is_space(*p)) p++;
+  if (p == start) return false;
+
+  if (end - p < 3 || p[0] != '(' || p[1] != '0' || (p[2] | 0x20) != 'x') return false;
+  p += 3;
+  start = p;
+  uint64_t value = 0;
+  bool overflow = false;
+  int digit;
+  while (p != end && (digit = hex_value(*p)) >= 0) {
+    overflow |= (value >> 60) != 0;
+    value = (value << 4) | digit;
+    p++;
+  }
+  if (p == start || p == end || *p != ')') return false;
+
+  *opcode = overflow ? UINT64_MAX : value;
+  return true;
+}
+
+// Memoizes disassembler_t::lookup, which walks hash chains that are long
+// for compressed and most other instructions, while logs only ever contain
+// a few thousand distinct opcodes
+class mnemonic_cache_t
+{
+ public:
+  mnemonic_cache_t(const disassembler_t* disasm) : disasm(disasm) {}
+
+  const char* lookup(uint64_t opcode)
+  {
+    auto it = names.find(opcode);
+    if (it != names.end())
+      return it->second;
+    const disasm_insn_t* insn = disasm->lookup(opcode);
+    return names[opcode] = insn ? insn->get_name() : "unknown_op";
+  }
+
+ private:
+  const disassembler_t* disasm;
+  unordered_map<uint64_t, const char*> names;
+};
+
+static void scan_chunk(const char* p, const char* end, mnemonic_cache_t* cache, string* out)
+{
+  out->clear();
+  while (p != end) {
+    const char* eol = (const char*)memchr(p, '\n', end - p);
+    if (!eol) eol = end;
+    uint64_t opcode;
+    if (scan_line(p, eol, &opcode)) {
+      out->append(cache->lookup(opcode));
+      out->push_back('\n');
+    }
+    p = eol == end ? end : eol + 1;
+  }
+}
+
+// Hands out line-aligned chunks of the input, from a mapping of it when it
+// is a regular file, otherwise from blocks read into owned buffers
+class chunk_reader_t
+{
+ public:
+  chunk_reader_t(int fd) : fd(fd), map(NULL), map_size(0), map_pos(0), eof(false)
+  {
+    struct stat st;
+    off_t pos = lseek(fd, 0, SEEK_CUR);
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && pos >= 0 && st.st_size > pos) {
+      void* m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (m != MAP_FAILED) {
+        map = (const char*)m;
+        map_size = st.st_size;
+        map_pos = pos; // where the input starts, e.g. after a shell's reads
+        madvise(m, map_size, MADV_SEQUENTIAL);
+      }
+    }
+  }
+
+  ~chunk_reader_t()
+  {
+    if (map)
+      munmap((void*)map, map_size);
+  }
+
+  // Fills [*begin, *end) with the next chunk, which ends after a newline
+  // unless it is the end of the input. <buf> holds the chunk if it has to
+  // be read. Returns false at the end of the input.
+  bool next(string* buf, const char** begin, const char** end)
+  {
+    if (map) {
+      if (map_pos == map_size)
+        return false;
+      size_t stop = map_pos + CHUNK_SIZE;
+      if (stop >= map_size) {
+        stop = map_size;
+      } else {
+        const char* eol = (const char*)memchr(map + stop, '\n', map_size - stop);
+        stop = eol ? eol - map + 1 : map_size;
+      }
+      *begin = map + map_pos;
+      *end = map + stop;
+      map_pos = stop;
+      return true;
+    }
+
+    buf->swap(carry);
+    carry.clear();
+    size_t eol = string::npos;
+    while (!eof && (buf->size() < CHUNK_SIZE || (eol = buf->rfind('\n')) == string::npos)) {
+      size_t old_size = buf->size();
+      buf->resize(old_size + CHUNK_SIZE);
+      ssize_t n = read(fd, &(*buf)[old_size], CHUNK_SIZE);
+      buf->resize(old_size + (n > 0 ? n : 0));
+      if (n <= 0)
+        eof = true;
+    }
+    if (buf->empty())
+      return false;
+    if (!eof) {
+      carry.assign(*buf, eol + 1, string::npos);
+      buf->resize(eol + 1);
+    }
+    *begin = buf->data();
+    *end = buf->data() + buf->size();
+    return true;
+  }
+
+ private:
+  int fd;
+  const char* map;
+  size_t map_size;
+  size_t map_pos;
+  bool eof;
+  string carry; // partial line at the end of the last block read
+};
+
 int main(int argc, char** argv)
 {
-  string s;
   const char* isa = DEFAULT_ISA;
+  size_t nthreads = thread::hardware_concurrency();
 
   std::function<extension_t*()> extension;
   option_parser_t parser;
   parser.option(0, "extension", 1, [&](const char* s){extension = find_extension(s);});
   parser.option(0, "isa", 1, [&](const char* s){isa = s;});
+  parser.option(0, "threads", 1, [&](const char* s){nthreads = atoi(s);});
   parser.parse(argv);
+  if (nthreads < 1)
+    nthreads = 1;
 
   processor_t p(isa, DEFAULT_PRIV, DEFAULT_VARCH, 0, 0, false, nullptr);
   if (extension) {
     p.register_extension(extension());
   }
 
-  std::regex reg("^core\\s+\\d+:\\s+0x[0-9a-f]+\\s+\\(0x([0-9a-f]+)\\)", std::regex_constants::icase);
-  std::smatch m;
-  std::ssub_match sm ;
+  // disassembler_t::lookup is const, so each thread can keep its own cache
+  vector<mnemonic_cache_t> caches(nthreads, mnemonic_cache_t(p.get_disassembler()));
+  vector<string> bufs(nthreads), outs(nthreads);
+  vector<const char*> begins(nthreads), ends(nthreads);
+  chunk_reader_t reader(STDIN_FILENO);
 
-  while (getline(cin,s)){
-    if (regex_search(s, m, reg)){
-      // the opcode string
-      string op = m[1].str();
-      uint32_t bit_num = op.size() * 4;
-      uint64_t opcode = strtoull(op.c_str(), nullptr, 16);
+  bool more = true;
+  while (more) {
+    size_t n = 0;
+    while (n < nthreads && (more = reader.next(&bufs[n], &begins[n], &ends[n])))
+      n++;
 
-      if (bit_num<64){
-          opcode = opcode << (64-bit_num) >> (64-bit_num);
-      }
+    vector<thread> workers;
+    for (size_t i = 1; i < n; i++)
+      workers.emplace_back(scan_chunk, begins[i], ends[i], &caches[i], &outs[i]);
+    if (n > 0)
+      scan_chunk(begins[0], ends[0], &caches[0], &outs[0]);
+    for (auto& w : workers)
+      w.join();
 
-      const disasm_insn_t* disasm = p.get_disassembler()->lookup(opcode);
-      if (disasm) {
-          cout << disasm->get_name() << '\n';
-      } else {
-          cout << "unknown_op\n";
-      }
-    }
+    for (size_t i = 0; i < n; i++)
+      fwrite(outs[i].data(), 1, outs[i].size(), stdout);
   }
 
   return 0;